@@ -0,0 +1,119 @@
+#!/usr/bin/env bash
+# Local soak harness: one dedicated server and N headless clients over localhost.
+#
+# Every client replays a recorded input stream into its own pawn while the
+# server replays the same stream into extra AI bots. Network emulation is
+# applied on both ends. Server and clients log a soak report
+# (Template.Soak.ReportInterval) with game thread time, ability activation
+# requests, prediction rejections and per connection bytes per second.
+#
+# Record a stream first from a game session:
+#   Template.Input.Record  ...play...  Template.Input.StopRecord Soak
+#
+# Usage:
+#   UE_ROOT=/path/to/UnrealEngine Scripts/soak_local.sh [options]
+#
+# Options (environment variables):
+#   NUM_CLIENTS=8        headless clients to start
+#   NUM_BOTS=0           AI characters the server drives with the same stream
+#   STREAM=Soak          recorded stream name in Saved/InputRecordings
+#   DURATION=300         seconds before every process is stopped
+#   PKT_LAG=60           emulated latency in ms
+#   PKT_LAG_VARIANCE=10  emulated latency variance in ms
+#   PKT_LOSS=1           emulated packet loss in percent
+#   REPORT_INTERVAL=5    seconds between soak reports
+#   FPS=30               fixed frame rate, keeps replays frame accurate
+#   MAP=/Game/ThirdPerson/Maps/ThirdPersonMap
+#   PORT=7777
+#   SERVER_BIN=          packaged GameTemplateServer binary, the editor binary is used otherwise
+#   CLIENT_BIN=          packaged GameTemplate binary, the editor binary is used otherwise
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT="$(cd "$SCRIPT_DIR/.." && pwd)/GameTemplate.uproject"
+
+NUM_CLIENTS="${NUM_CLIENTS:-8}"
+NUM_BOTS="${NUM_BOTS:-0}"
+STREAM="${STREAM:-Soak}"
+DURATION="${DURATION:-300}"
+PKT_LAG="${PKT_LAG:-60}"
+PKT_LAG_VARIANCE="${PKT_LAG_VARIANCE:-10}"
+PKT_LOSS="${PKT_LOSS:-1}"
+REPORT_INTERVAL="${REPORT_INTERVAL:-5}"
+FPS="${FPS:-30}"
+MAP="${MAP:-/Game/ThirdPerson/Maps/ThirdPersonMap}"
+PORT="${PORT:-7777}"
+
+LOG_DIR="$(dirname "$PROJECT")/Saved/Soak/$(date +%Y%m%d-%H%M%S)"
+mkdir -p "$LOG_DIR"
+
+if [[ -n "${SERVER_BIN:-}" ]]; then
+	SERVER_CMD=("$SERVER_BIN")
+else
+	: "${UE_ROOT:?Set UE_ROOT to the engine root or SERVER_BIN to a packaged server}"
+	SERVER_CMD=("$UE_ROOT/Engine/Binaries/Linux/UnrealEditor" "$PROJECT" -server)
+fi
+
+if [[ -n "${CLIENT_BIN:-}" ]]; then
+	CLIENT_CMD=("$CLIENT_BIN")
+else
+	: "${UE_ROOT:?Set UE_ROOT to the engine root or CLIENT_BIN to a packaged client}"
+	CLIENT_CMD=("$UE_ROOT/Engine/Binaries/Linux/UnrealEditor" "$PROJECT" -game)
+fi
+
+COMMON_ARGS=(
+	-unattended -nosound -nosplash -stdout -FullStdOutLogOutput
+	-benchmark "-fps=$FPS"
+	"-PktLag=$PKT_LAG" "-PktLagVariance=$PKT_LAG_VARIANCE" "-PktLoss=$PKT_LOSS"
+	"-ini:Engine:[ConsoleVariables]:Template.Soak.ReportInterval=$REPORT_INTERVAL"
+)
+
+PIDS=()
+cleanup()
+{
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT INT TERM
+
+SERVER_ARGS=("$MAP" "-port=$PORT" "${COMMON_ARGS[@]}")
+if (( NUM_BOTS > 0 )); then
+	SERVER_ARGS+=("-TemplateInputReplay=$STREAM" "-TemplateInputReplayCharacters=$NUM_BOTS")
+fi
+
+echo "Server: $LOG_DIR/Server.log"
+"${SERVER_CMD[@]}" "${SERVER_ARGS[@]}" "-abslog=$LOG_DIR/Server.log" > /dev/null 2>&1 &
+PIDS+=($!)
+
+# Give the server time to load the map before clients connect
+sleep 10
+
+for (( CLIENT = 0; CLIENT < NUM_CLIENTS; CLIENT++ )); do
+	echo "Client $CLIENT: $LOG_DIR/Client$CLIENT.log"
+	"${CLIENT_CMD[@]}" "127.0.0.1:$PORT" -nullrhi "${COMMON_ARGS[@]}" \
+		"-TemplateInputReplay=$STREAM" -TemplateInputReplayCharacters=1 \
+		"-abslog=$LOG_DIR/Client$CLIENT.log" > /dev/null 2>&1 &
+	PIDS+=($!)
+done
+
+sleep "$DURATION"
+
+# A report is the Frames summary line and every Soak line after it, print the last one whole
+echo "Last server report:"
+awk '/Soak: Frames=/ { Report = "" } /Soak:/ { Report = Report $0 "\n" } END { printf "%s", Report }' "$LOG_DIR/Server.log"
+
+# Activation requests only count ability RPCs sent by clients, server driven bots don't add to them
+TOTALS="$(awk '
+	match($0, /ActivationRequests=[0-9]+/) { Requests += substr($0, RSTART + 19, RLENGTH - 19) }
+	match($0, /BatchedRPCs=[0-9]+/) { Batched += substr($0, RSTART + 12, RLENGTH - 12) }
+	END { printf "%d %d", Requests, Batched }' "$LOG_DIR/Server.log")"
+read -r ACTIVATION_REQUESTS BATCHED_RPCS <<< "$TOTALS"
+
+echo "Server totals: ActivationRequests=$ACTIVATION_REQUESTS BatchedRPCs=$BATCHED_RPCS"
+if (( ACTIVATION_REQUESTS == 0 )); then
+	echo "Soak failed: no client sent an ability RPC, check the recorded stream presses bound ability input" >&2
+	exit 1
+fi
@@ -4,4 +4,6 @@
 
 #include "CoreMinimal.h"
 
-DECLARE_LOG_CATEGORY_EXTERN(ProjectLog, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(ProjectLog, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("TemplateAbilitySystem"), STATGROUP_TemplateAbilitySystem, STATCAT_Advanced);
\ No newline at end of file
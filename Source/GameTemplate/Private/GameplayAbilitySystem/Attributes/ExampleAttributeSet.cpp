@@ -2,20 +2,71 @@
 
 
 #include "GameplayAbilitySystem/Attributes/ExampleAttributeSet.h"
+#include "GameplayEffectExtension.h"
+#include "Net/UnrealNetwork.h"
 
 UExampleAttributeSet::UExampleAttributeSet()
 	: Stamina(100.0f)
+	, Energy(100.0f, 0.0f, 100.0f)
+	, EnergyChange(0.0f)
 {
 }
 
-void UExampleAttributeSet::PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const
+void UExampleAttributeSet::SetEnergy(float NewValue)
 {
-	Super::PreAttributeBaseChange(Attribute, NewValue);
+	SetRateAttributeValue(Energy, NewValue);
+	OnEnergyChanged.Broadcast(GetEnergy(), Energy.Rate);
+}
+
+void UExampleAttributeSet::SetEnergyRate(float NewRate)
+{
+	SetRateAttributeRate(Energy, NewRate);
+	OnEnergyChanged.Broadcast(GetEnergy(), Energy.Rate);
+}
+
+void UExampleAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	// Clamp stamina value
-	if (Attribute == GetStaminaAttribute())
+	DOREPLIFETIME_CONDITION_NOTIFY(UExampleAttributeSet, Energy, COND_None, REPNOTIFY_OnChanged);
+}
+
+void UExampleAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
+{
+	Super::PostGameplayEffectExecute(Data);
+
+	// Effects reach the rate attribute through the meta attribute, the current rate keeps running
+	if (Data.EvaluatedData.Attribute == GetEnergyChangeAttribute())
 	{
-		// Do not allow health to go negative or above max stamina
-		NewValue = FMath::Clamp(NewValue, 0.0f, 100.0f);
+		const float Change = GetEnergyChange();
+		SetEnergyChange(0.0f);
+		SetEnergy(GetEnergy() + Change);
 	}
 }
+
+void UExampleAttributeSet::OnRep_Energy(const FTemplateRateAttributeData& OldEnergy)
+{
+	// Clients evaluate the value on demand, a replicated change only needs to be announced
+	OnEnergyChanged.Broadcast(GetEnergy(), Energy.Rate);
+}
+
+void UExampleAttributeSet::OnRateAttributeBoundReached(FTemplateRateAttributeData& Data, bool bReachedMax)
+{
+	Super::OnRateAttributeBoundReached(Data, bReachedMax);
+
+	// The rate stopped at the bound
+	if (&Data == &Energy)
+	{
+		OnEnergyChanged.Broadcast(GetEnergy(), Energy.Rate);
+	}
+}
+
+TConstArrayView<FTemplateAttributeMetaData> UExampleAttributeSet::GetAttributeMetaData() const
+{
+	// Do not allow stamina to go negative or above max stamina
+	static constexpr FTemplateAttributeMetaData MetaData[] =
+	{
+		ATTRIBUTE_METADATA(UExampleAttributeSet, Stamina, 0.0f, 100.0f),
+	};
+	return MetaData;
+}
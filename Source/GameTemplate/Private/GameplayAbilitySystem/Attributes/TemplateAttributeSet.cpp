@@ -3,8 +3,290 @@
 
 #include "GameplayAbilitySystem/Attributes/TemplateAttributeSet.h"
 #include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "TimerManager.h"
+
+/**
+ * Clamp metadata of one attribute set class, indexed by the offset of the attribute properties
+ */
+struct FTemplateAttributeMetaDataTable
+{
+	struct FEntry
+	{
+		/** Checked against the looked up attribute, an offset of a parent class may hold another property **/
+		const FProperty* Property = nullptr;
+
+		float MinValue = 0.0f;
+		float MaxValue = 0.0f;
+		FGameplayAttribute MaxAttribute;
+	};
+
+	/** Entry index for every attribute aligned offset of the class, INDEX_NONE where no attribute has metadata **/
+	TArray<int16> OffsetIndices;
+	TArray<FEntry> Entries;
+
+	static int32 GetOffsetIndex(const FProperty* Property)
+	{
+		return Property->GetOffset_ForInternal() / alignof(FGameplayAttributeData);
+	}
+
+	const FEntry* Find(const FProperty* Property) const
+	{
+		const int32 OffsetIndex = Property ? GetOffsetIndex(Property) : INDEX_NONE;
+		const int32 EntryIndex = OffsetIndices.IsValidIndex(OffsetIndex) ? OffsetIndices[OffsetIndex] : INDEX_NONE;
+		return EntryIndex != INDEX_NONE && Entries[EntryIndex].Property == Property ? &Entries[EntryIndex] : nullptr;
+	}
+};
+
+double FTemplateRateAttributeData::GetTimeToBound(double WorldTime) const
+{
+	const float Value = GetValue(WorldTime);
+
+	if (Rate > 0.0f && Value < MaxValue)
+	{
+		return (MaxValue - Value) / Rate;
+	}
+	if (Rate < 0.0f && Value > MinValue)
+	{
+		return (MinValue - Value) / Rate;
+	}
+	return -1.0;
+}
 
 UTemplateAbilitySystemComponent* UTemplateAttributeSet::GetAbilitySystemComponent() const
 {
 	return Cast<UTemplateAbilitySystemComponent>(GetOwningAbilitySystemComponent());
 }
+
+void UTemplateAttributeSet::SerializeCheckpoint(FArchive& Ar)
+{
+	UTemplateAbilitySystemComponent* Asc = GetAbilitySystemComponent();
+
+	TArray<FStructProperty*, TInlineAllocator<16>> Properties;
+	for (TFieldIterator<FStructProperty> It(GetClass()); It; ++It)
+	{
+		if (FGameplayAttribute::IsGameplayAttributeDataProperty(*It) || It->Struct == FTemplateRateAttributeData::StaticStruct())
+		{
+			Properties.Add(*It);
+		}
+	}
+
+	// A different layout means the blob was written by another build
+	uint32 NumProperties = Properties.Num();
+	Ar.SerializeIntPacked(NumProperties);
+	if (Ar.IsLoading() && (NumProperties != static_cast<uint32>(Properties.Num()) || !Asc))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	for (FStructProperty* Property : Properties)
+	{
+		if (Property->Struct == FTemplateRateAttributeData::StaticStruct())
+		{
+			FTemplateRateAttributeData& Data = *Property->ContainerPtrToValuePtr<FTemplateRateAttributeData>(this);
+
+			float Value = GetRateAttributeValue(Data);
+			float Rate = Data.Rate;
+			Ar << Value;
+			Ar << Rate;
+
+			if (Ar.IsLoading() && !Ar.IsError())
+			{
+				SetRateAttributeValue(Data, Value);
+				SetRateAttributeRate(Data, Rate);
+			}
+			continue;
+		}
+
+		// Current values are rebuilt from the base by the effects restored afterwards
+		const FGameplayAttribute Attribute(Property);
+		float BaseValue = Property->ContainerPtrToValuePtr<FGameplayAttributeData>(this)->GetBaseValue();
+		Ar << BaseValue;
+
+		if (Ar.IsLoading() && !Ar.IsError())
+		{
+			Asc->SetNumericAttributeBase(Attribute, BaseValue);
+		}
+	}
+}
+
+void UTemplateAttributeSet::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// The default object builds the table once per class, instances share it. Each class has its own,
+	// so a class replaced by a hot reload or Blueprint compile never reads the properties of the old one
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		MetaDataTable = GetClass()->GetDefaultObject<UTemplateAttributeSet>()->MetaDataTable;
+		return;
+	}
+
+	const TConstArrayView<FTemplateAttributeMetaData> MetaData = GetAttributeMetaData();
+	if (MetaData.Num() == 0)
+	{
+		return;
+	}
+
+	TSharedRef<FTemplateAttributeMetaDataTable> Table = MakeShared<FTemplateAttributeMetaDataTable>();
+	Table->OffsetIndices.Init(INDEX_NONE, GetClass()->GetStructureSize() / alignof(FGameplayAttributeData) + 1);
+	Table->Entries.Reserve(MetaData.Num());
+
+	for (const FTemplateAttributeMetaData& AttributeMetaData : MetaData)
+	{
+		check(AttributeMetaData.GetAttribute);
+		const FProperty* Property = AttributeMetaData.GetAttribute().GetUProperty();
+		check(Property && Table->OffsetIndices.IsValidIndex(FTemplateAttributeMetaDataTable::GetOffsetIndex(Property)));
+
+		Table->OffsetIndices[FTemplateAttributeMetaDataTable::GetOffsetIndex(Property)] = static_cast<int16>(Table->Entries.Num());
+
+		FTemplateAttributeMetaDataTable::FEntry& Entry = Table->Entries.AddDefaulted_GetRef();
+		Entry.Property = Property;
+		Entry.MinValue = AttributeMetaData.MinValue;
+		Entry.MaxValue = AttributeMetaData.MaxValue;
+		if (AttributeMetaData.GetMaxAttribute)
+		{
+			Entry.MaxAttribute = AttributeMetaData.GetMaxAttribute();
+		}
+	}
+
+	MetaDataTable = MoveTemp(Table);
+}
+
+void UTemplateAttributeSet::BeginDestroy()
+{
+	// Instances still alive keep the table through their own reference
+	MetaDataTable.Reset();
+
+	Super::BeginDestroy();
+}
+
+void UTemplateAttributeSet::PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const
+{
+	Super::PreAttributeBaseChange(Attribute, NewValue);
+
+	ClampAttributeValue(Attribute, NewValue);
+}
+
+void UTemplateAttributeSet::ClampAttributeValue(const FGameplayAttribute& Attribute, float& NewValue) const
+{
+	const FTemplateAttributeMetaDataTable::FEntry* Entry = MetaDataTable.IsValid() ? MetaDataTable->Find(Attribute.GetUProperty()) : nullptr;
+	if (Entry)
+	{
+		const float MaxValue = Entry->MaxAttribute.IsValid() ? Entry->MaxAttribute.GetNumericValue(this) : Entry->MaxValue;
+		NewValue = FMath::Clamp(NewValue, Entry->MinValue, MaxValue);
+	}
+}
+
+void UTemplateAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	Super::PostAttributeChange(Attribute, OldValue, NewValue);
+
+	if (bCoalesceChangeNotifies)
+	{
+		if (UTemplateAbilitySystemComponent* Asc = GetAbilitySystemComponent())
+		{
+			Asc->QueueAttributeChange(Attribute, OldValue, NewValue);
+		}
+	}
+}
+
+float UTemplateAttributeSet::GetRateAttributeValue(const FTemplateRateAttributeData& Data) const
+{
+	return Data.GetValue(GetServerWorldTime());
+}
+
+void UTemplateAttributeSet::SetRateAttributeRate(FTemplateRateAttributeData& Data, float NewRate)
+{
+	const double WorldTime = GetServerWorldTime();
+
+	Data.BaseValue = Data.GetValue(WorldTime);
+	Data.Rate = NewRate;
+	Data.RateStartTime = WorldTime;
+
+	ScheduleRateAttributeBound(Data);
+}
+
+void UTemplateAttributeSet::SetRateAttributeValue(FTemplateRateAttributeData& Data, float NewValue)
+{
+	Data.BaseValue = FMath::Clamp(NewValue, Data.MinValue, Data.MaxValue);
+	Data.RateStartTime = GetServerWorldTime();
+
+	ScheduleRateAttributeBound(Data);
+}
+
+double UTemplateAttributeSet::GetServerWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return 0.0;
+	}
+
+	// Server time keeps clients evaluating the same curve as the authority
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UTemplateAttributeSet::ScheduleRateAttributeBound(FTemplateRateAttributeData& Data)
+{
+	UWorld* World = GetWorld();
+	const AActor* OwningActor = GetOwningActor();
+	if (!World || !OwningActor || !OwningActor->HasAuthority())
+	{
+		return;
+	}
+
+	World->GetTimerManager().ClearTimer(Data.BoundTimerHandle);
+
+	const double TimeToBound = Data.GetTimeToBound(GetServerWorldTime());
+	if (TimeToBound > 0.0)
+	{
+		const TFieldPath<FStructProperty> Property(FindRateAttributeProperty(Data));
+		World->GetTimerManager().SetTimer(Data.BoundTimerHandle, FTimerDelegate::CreateUObject(this, &UTemplateAttributeSet::HandleRateAttributeBound, Property), static_cast<float>(TimeToBound), false);
+	}
+	else if (Data.Rate != 0.0f)
+	{
+		// Already at the bound the rate moves towards
+		ReachRateAttributeBound(Data);
+	}
+}
+
+void UTemplateAttributeSet::HandleRateAttributeBound(TFieldPath<FStructProperty> Property)
+{
+	const FStructProperty* StructProperty = Property.Get();
+	if (!ensure(StructProperty))
+	{
+		return;
+	}
+
+	ReachRateAttributeBound(*StructProperty->ContainerPtrToValuePtr<FTemplateRateAttributeData>(this));
+}
+
+void UTemplateAttributeSet::ReachRateAttributeBound(FTemplateRateAttributeData& Data)
+{
+	const bool bReachedMax = Data.Rate > 0.0f;
+
+	// Rest on the bound, a rate left running would keep extrapolating from this start time on every later change
+	Data.BaseValue = bReachedMax ? Data.MaxValue : Data.MinValue;
+	Data.Rate = 0.0f;
+	Data.RateStartTime = GetServerWorldTime();
+
+	OnRateAttributeBoundReached(Data, bReachedMax);
+}
+
+FStructProperty* UTemplateAttributeSet::FindRateAttributeProperty(const FTemplateRateAttributeData& Data) const
+{
+	for (TFieldIterator<FStructProperty> It(GetClass()); It; ++It)
+	{
+		if (It->Struct == FTemplateRateAttributeData::StaticStruct() && It->ContainerPtrToValuePtr<FTemplateRateAttributeData>(this) == &Data)
+		{
+			return *It;
+		}
+	}
+
+	checkf(false, TEXT("Rate attribute data must be a property of [%s]"), *GetNameSafe(GetClass()));
+	return nullptr;
+}
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateAbilityCheckpoint.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace AbilityCheckpointImpl
+{
+	/** Packs small signed values, INDEX_NONE included **/
+	static void SerializeIndex(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = static_cast<uint32>(Value + 1);
+		Ar.SerializeIntPacked(Packed);
+		Value = static_cast<int32>(Packed) - 1;
+	}
+
+	/** Bytes left to read, 0 once the archive is in error **/
+	static int64 GetRemainingSize(FArchive& Ar)
+	{
+		return Ar.IsError() ? 0 : FMath::Max<int64>(0, Ar.TotalSize() - Ar.Tell());
+	}
+
+	/** Every element takes at least one byte, reject counts the rest of the archive can't hold **/
+	template <typename ElementType>
+	static bool SerializeNum(FArchive& Ar, TArray<ElementType>& Array)
+	{
+		uint32 Num = Array.Num();
+		Ar.SerializeIntPacked(Num);
+
+		if (Ar.IsLoading())
+		{
+			if (Ar.IsError() || Num > GetRemainingSize(Ar))
+			{
+				Ar.SetError();
+				return false;
+			}
+			Array.SetNum(Num);
+		}
+		return !Ar.IsError();
+	}
+
+	/** Checks the saved length against the rest of the archive before the string allocates it **/
+	static bool SerializeString(FArchive& Ar, FString& String)
+	{
+		if (Ar.IsLoading())
+		{
+			const int64 LengthOffset = Ar.Tell();
+			int32 SaveNum = 0;
+			Ar << SaveNum;
+
+			// Negative lengths are UTF-16
+			const int64 NumBytes = SaveNum == MIN_int32 ? MAX_int64 : (SaveNum < 0 ? -static_cast<int64>(SaveNum) * sizeof(UTF16CHAR) : SaveNum);
+			if (Ar.IsError() || NumBytes > GetRemainingSize(Ar))
+			{
+				Ar.SetError();
+				return false;
+			}
+			Ar.Seek(LengthOffset);
+		}
+
+		Ar << String;
+		return !Ar.IsError();
+	}
+
+	/** Raw bytes after a packed count **/
+	static bool SerializeBytes(FArchive& Ar, TArray<uint8>& Bytes)
+	{
+		if (!SerializeNum(Ar, Bytes))
+		{
+			return false;
+		}
+		Ar.Serialize(Bytes.GetData(), Bytes.Num());
+		return !Ar.IsError();
+	}
+}
+
+void FTemplateAbilityCheckpoint::Serialize(FArchive& Ar)
+{
+	using namespace AbilityCheckpointImpl;
+
+	uint32 CheckpointMagic = Magic;
+	uint32 CheckpointVersion = Version;
+	Ar << CheckpointMagic;
+	Ar << CheckpointVersion;
+
+	if (Ar.IsLoading() && (CheckpointMagic != Magic || CheckpointVersion != Version))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	if (!SerializeNum(Ar, AbilitySets))
+	{
+		return;
+	}
+	for (FAbilitySetState& AbilitySet : AbilitySets)
+	{
+		if (!SerializeString(Ar, AbilitySet.AbilitySetPath) || !SerializeNum(Ar, AbilitySet.Abilities))
+		{
+			return;
+		}
+		for (FAbilityState& Ability : AbilitySet.Abilities)
+		{
+			SerializeIndex(Ar, Ability.Level);
+			SerializeIndex(Ar, Ability.InputID);
+		}
+	}
+
+	if (!SerializeNum(Ar, Effects))
+	{
+		return;
+	}
+	for (FEffectState& Effect : Effects)
+	{
+		if (!SerializeString(Ar, Effect.EffectClassPath))
+		{
+			return;
+		}
+		Ar << Effect.Level;
+		SerializeIndex(Ar, Effect.StackCount);
+		Ar << Effect.RemainingDuration;
+		SerializeIndex(Ar, Effect.AbilitySetIndex);
+	}
+
+	if (!SerializeNum(Ar, AttributeSets))
+	{
+		return;
+	}
+	for (FAttributeSetState& AttributeSet : AttributeSets)
+	{
+		if (!SerializeString(Ar, AttributeSet.AttributeSetClassPath) || !SerializeBytes(Ar, AttributeSet.Values))
+		{
+			return;
+		}
+	}
+}
+
+void FTemplateAbilityCheckpoint::SaveToBytes(TArray<uint8>& OutBytes)
+{
+	FMemoryWriter Writer(OutBytes);
+	Serialize(Writer);
+}
+
+bool FTemplateAbilityCheckpoint::LoadFromBytes(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader);
+
+	return !Reader.IsError();
+}
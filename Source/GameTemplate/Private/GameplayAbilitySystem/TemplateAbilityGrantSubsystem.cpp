@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateAbilityGrantSubsystem.h"
+
+#include "GameTemplate.h"
+#include "GameplayAbilitySystem/TemplateGameplayAbilitySet.h"
+#include "Player/GameTemplateCharacter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Commit Ability Grants"), STAT_TemplateAbilityGrant_Commit, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ability Grants Committed"), STAT_TemplateAbilityGrant_Committed, STATGROUP_TemplateAbilitySystem);
+
+static TAutoConsoleVariable<float> CVarAbilityGrantFrameBudgetMs(
+	TEXT("Template.AbilityGrant.FrameBudgetMs"),
+	0.0f,
+	TEXT("Game thread milliseconds per frame spent committing queued ability set grants. 0 grants immediately"));
+
+bool UTemplateAbilityGrantSubsystem::IsTimeSliced()
+{
+	return CVarAbilityGrantFrameBudgetMs.GetValueOnGameThread() > 0.0f;
+}
+
+void UTemplateAbilityGrantSubsystem::QueueGrant(AGameTemplateCharacter* Character)
+{
+	check(Character);
+
+	// Resolve set data now, it is shared by every character using the set
+	for (UTemplateGameplayAbilitySet* AbilitySet : Character->GetAbilitySets())
+	{
+		if (AbilitySet)
+		{
+			AbilitySet->GetGrantData();
+		}
+	}
+
+	PendingGrants.AddUnique(Character);
+}
+
+void UTemplateAbilityGrantSubsystem::CancelGrant(AGameTemplateCharacter* Character)
+{
+	PendingGrants.Remove(Character);
+}
+
+void UTemplateAbilityGrantSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingGrants.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TemplateAbilityGrant_Commit);
+
+	// Always commit at least one grant so the queue drains under any budget.
+	// Each grant leaves the queue before it is committed, committing may queue or cancel others
+	const double Deadline = FPlatformTime::Seconds() + CVarAbilityGrantFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	do
+	{
+		const TWeakObjectPtr<AGameTemplateCharacter> NextGrant = PendingGrants[0];
+		PendingGrants.RemoveAt(0, 1, false);
+
+		if (AGameTemplateCharacter* Character = NextGrant.Get())
+		{
+			Character->CommitAbilitySets();
+			INC_DWORD_STAT(STAT_TemplateAbilityGrant_Committed);
+		}
+	}
+	while (PendingGrants.Num() > 0 && FPlatformTime::Seconds() < Deadline);
+}
+
+TStatId UTemplateAbilityGrantSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTemplateAbilityGrantSubsystem, STATGROUP_Tickables);
+}
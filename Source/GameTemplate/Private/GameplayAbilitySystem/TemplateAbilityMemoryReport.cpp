@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateAbilityMemoryReport.h"
+
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Player/GameTemplateCharacter.h"
+
+SIZE_T FTemplateAbilityMemoryUsage::GetAbilitySetsTotal() const
+{
+	SIZE_T Total = 0;
+	for (const TPair<FString, SIZE_T>& AbilitySet : AbilitySets)
+	{
+		Total += AbilitySet.Value;
+	}
+	return Total;
+}
+
+SIZE_T FTemplateAbilityMemoryUsage::GetTotal() const
+{
+	return AbilitySystemComponent + ActivatableAbilities + ActiveEffects + AttributeSets + InputBindings + GetAbilitySetsTotal();
+}
+
+void TemplateAbilityMemoryReport::Gather(UWorld* World, TArray<FTemplateAbilityMemoryUsage>& OutUsages)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	for (TActorIterator<AGameTemplateCharacter> It(World); It; ++It)
+	{
+		FTemplateAbilityMemoryUsage& Usage = OutUsages.AddDefaulted_GetRef();
+		Usage.CharacterName = It->GetName();
+		It->AccumulateAbilityMemoryUsage(Usage);
+	}
+}
+
+void TemplateAbilityMemoryReport::Print(TArray<FTemplateAbilityMemoryUsage> Usages, int32 NumLargest, FOutputDevice& Ar)
+{
+	Usages.Sort([](const FTemplateAbilityMemoryUsage& A, const FTemplateAbilityMemoryUsage& B) { return A.GetTotal() > B.GetTotal(); });
+
+	FTemplateAbilityMemoryUsage Totals;
+	TMap<FString, SIZE_T> AbilitySetTotals;
+
+	Ar.Logf(TEXT("%-32s %10s %10s %10s %10s %10s %10s %10s"), TEXT("Character"), TEXT("ASC"), TEXT("Specs"), TEXT("Effects"), TEXT("Attributes"), TEXT("Input"), TEXT("Sets"), TEXT("Total"));
+
+	for (int32 Index = 0; Index < Usages.Num(); ++Index)
+	{
+		const FTemplateAbilityMemoryUsage& Usage = Usages[Index];
+
+		if (Index < NumLargest)
+		{
+			Ar.Logf(TEXT("%-32s %10llu %10llu %10llu %10llu %10llu %10llu %10llu"), *Usage.CharacterName,
+				(uint64)Usage.AbilitySystemComponent, (uint64)Usage.ActivatableAbilities, (uint64)Usage.ActiveEffects,
+				(uint64)Usage.AttributeSets, (uint64)Usage.InputBindings, (uint64)Usage.GetAbilitySetsTotal(), (uint64)Usage.GetTotal());
+		}
+
+		Totals.AbilitySystemComponent += Usage.AbilitySystemComponent;
+		Totals.ActivatableAbilities += Usage.ActivatableAbilities;
+		Totals.ActiveEffects += Usage.ActiveEffects;
+		Totals.AttributeSets += Usage.AttributeSets;
+		Totals.InputBindings += Usage.InputBindings;
+
+		for (const TPair<FString, SIZE_T>& AbilitySet : Usage.AbilitySets)
+		{
+			AbilitySetTotals.FindOrAdd(AbilitySet.Key) += AbilitySet.Value;
+		}
+	}
+
+	if (Usages.Num() > NumLargest)
+	{
+		Ar.Logf(TEXT("... %d more characters"), Usages.Num() - NumLargest);
+	}
+
+	for (const TPair<FString, SIZE_T>& AbilitySetTotal : AbilitySetTotals)
+	{
+		Totals.AbilitySets.Add(AbilitySetTotal);
+	}
+
+	Ar.Logf(TEXT("%-32s %10llu %10llu %10llu %10llu %10llu %10llu %10llu"), TEXT("TOTAL"),
+		(uint64)Totals.AbilitySystemComponent, (uint64)Totals.ActivatableAbilities, (uint64)Totals.ActiveEffects,
+		(uint64)Totals.AttributeSets, (uint64)Totals.InputBindings, (uint64)Totals.GetAbilitySetsTotal(), (uint64)Totals.GetTotal());
+
+	// Largest ability sets summed over every character
+	AbilitySetTotals.ValueSort([](SIZE_T A, SIZE_T B) { return A > B; });
+
+	int32 NumPrinted = 0;
+	for (const TPair<FString, SIZE_T>& AbilitySetTotal : AbilitySetTotals)
+	{
+		if (NumPrinted++ >= NumLargest)
+		{
+			break;
+		}
+		Ar.Logf(TEXT("AbilitySet %-32s %10llu"), *AbilitySetTotal.Key, (uint64)AbilitySetTotal.Value);
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice AbilityMemReportCommand(
+	TEXT("Template.AbilitySystem.MemReport"),
+	TEXT("Prints ability system memory per character and per ability set. Args: [NumLargest=10]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const int32 NumLargest = Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+		TArray<FTemplateAbilityMemoryUsage> Usages;
+		TemplateAbilityMemoryReport::Gather(World, Usages);
+		TemplateAbilityMemoryReport::Print(MoveTemp(Usages), NumLargest, Ar);
+	}));
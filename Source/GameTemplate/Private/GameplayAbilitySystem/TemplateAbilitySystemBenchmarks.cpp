@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameTemplate.h"
+#include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
+#include "GameplayAbilitySystem/Attributes/ExampleAttributeSet.h"
+#include "HAL/IConsoleManager.h"
+#include "Player/GameTemplateCharacter.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace TemplateAbilitySystemBenchmarks
+{
+	const TCHAR* DefaultEffectPath = TEXT("/Game/GE_DrainStamina.GE_DrainStamina_C");
+
+	static UTemplateAbilitySystemComponent* SpawnBenchmarkAbilitySystem(UWorld* World, TArray<AActor*>& SpawnedActors)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		SpawnedActors.Add(Actor);
+
+		UTemplateAbilitySystemComponent* Asc = NewObject<UTemplateAbilitySystemComponent>(Actor);
+		Asc->RegisterComponent();
+		Asc->InitAbilityActorInfo(Actor, Actor);
+		Asc->AddAttributeSetSubobject(NewObject<UExampleAttributeSet>(Actor));
+
+		return Asc;
+	}
+
+	static void RemoveAppliedEffects(TConstArrayView<UAbilitySystemComponent*> Targets, const TArray<FActiveGameplayEffectHandle>& Handles)
+	{
+		for (int32 Index = 0; Index < Handles.Num() && Index < Targets.Num(); ++Index)
+		{
+			if (Handles[Index].IsValid())
+			{
+				Targets[Index]->RemoveActiveGameplayEffect(Handles[Index]);
+			}
+		}
+	}
+
+	/** Compares a per-target apply loop against ApplyGameplayEffectSpecToTargets for 1, 10, 100... targets **/
+	static void RunApplyToTargets(const TArray<FString>& Args, UWorld* World)
+	{
+		const FString EffectPath = Args.IsValidIndex(0) ? Args[0] : DefaultEffectPath;
+		const int32 MaxTargets = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000;
+
+		UClass* EffectClass = LoadClass<UGameplayEffect>(nullptr, *EffectPath);
+		if (!World || !World->IsGameWorld() || !EffectClass)
+		{
+			UE_LOG(ProjectLog, Error, TEXT("ApplyToTargets benchmark needs a game world and a valid effect class [%s]"), *EffectPath);
+			return;
+		}
+
+		const UGameplayEffect* EffectCDO = EffectClass->GetDefaultObject<UGameplayEffect>();
+
+		TArray<AActor*> SpawnedActors;
+		UTemplateAbilitySystemComponent* Source = SpawnBenchmarkAbilitySystem(World, SpawnedActors);
+
+		TArray<UAbilitySystemComponent*> Targets;
+		Targets.Reserve(MaxTargets);
+		for (int32 Index = 0; Index < MaxTargets; ++Index)
+		{
+			Targets.Add(SpawnBenchmarkAbilitySystem(World, SpawnedActors));
+		}
+
+		for (int32 TargetCount = 1; ; TargetCount = FMath::Min(TargetCount * 10, MaxTargets))
+		{
+			const TConstArrayView<UAbilitySystemComponent*> TargetView(Targets.GetData(), TargetCount);
+			TArray<FActiveGameplayEffectHandle> Handles;
+			Handles.Reserve(TargetCount);
+
+			// Per-target loop, one spec and context each
+			double StartTime = FPlatformTime::Seconds();
+			for (UAbilitySystemComponent* Target : TargetView)
+			{
+				Handles.Add(Source->ApplyGameplayEffectToTarget(EffectCDO, Target, 1.0f, Source->MakeEffectContext()));
+			}
+			const double LoopMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			RemoveAppliedEffects(TargetView, Handles);
+			Handles.Reset();
+
+			// Shared spec, batched
+			StartTime = FPlatformTime::Seconds();
+			Source->ApplyGameplayEffectToTargets(EffectClass, 1.0f, TargetView, Handles);
+			const double BatchedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			RemoveAppliedEffects(TargetView, Handles);
+
+			UE_LOG(ProjectLog, Display, TEXT("ApplyToTargets [%s] targets=%d loop=%.3fms batched=%.3fms"),
+				*EffectClass->GetName(), TargetCount, LoopMs, BatchedMs);
+
+			if (TargetCount == MaxTargets)
+			{
+				break;
+			}
+		}
+
+		for (AActor* Actor : SpawnedActors)
+		{
+			Actor->Destroy();
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs ApplyToTargetsCommand(
+		TEXT("Template.Benchmark.ApplyToTargets"),
+		TEXT("Times applying an effect to 1..N targets one by one and through ApplyGameplayEffectSpecToTargets. Args: [EffectClassPath] [MaxTargets=1000]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunApplyToTargets));
+
+	/** Compares granting every ability set again against restoring a checkpoint of the first authoritative character **/
+	static void RunCheckpoint(const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations = Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+
+		AGameTemplateCharacter* Character = nullptr;
+		for (TActorIterator<AGameTemplateCharacter> It(World); World && It && !Character; ++It)
+		{
+			if (It->HasAuthority() && It->GetAbilitySystemComponent() && It->GetAbilitySets().Num() > 0)
+			{
+				Character = *It;
+			}
+		}
+
+		if (!World || !World->IsGameWorld() || !Character)
+		{
+			UE_LOG(ProjectLog, Error, TEXT("Checkpoint benchmark needs a game world with an authoritative character that has ability sets"));
+			return;
+		}
+
+		// The restore pass ends with the state the character had
+		FTemplateAbilityCheckpoint Checkpoint;
+		Character->SaveAbilityCheckpoint(Checkpoint);
+
+		TArray<uint8> Bytes;
+		Checkpoint.SaveToBytes(Bytes);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Character->RemoveAbilities();
+			Character->CommitAbilitySets();
+		}
+		const double RegrantMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FTemplateAbilityCheckpoint SavedCheckpoint;
+			Character->SaveAbilityCheckpoint(SavedCheckpoint);
+
+			TArray<uint8> SavedBytes;
+			SavedCheckpoint.SaveToBytes(SavedBytes);
+		}
+		const double SaveMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+
+		bool bRestored = true;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FTemplateAbilityCheckpoint LoadedCheckpoint;
+			bRestored &= LoadedCheckpoint.LoadFromBytes(Bytes) && Character->RestoreAbilityCheckpoint(LoadedCheckpoint);
+		}
+		const double RestoreMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+
+		UE_LOG(ProjectLog, Display, TEXT("Checkpoint [%s] sets=%d effects=%d attributeSets=%d size=%d bytes regrant=%.3fms save=%.3fms restore=%.3fms%s"),
+			*Character->GetName(), Checkpoint.AbilitySets.Num(), Checkpoint.Effects.Num(), Checkpoint.AttributeSets.Num(), Bytes.Num(),
+			RegrantMs, SaveMs, RestoreMs, bRestored ? TEXT("") : TEXT(" (restore failed)"));
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CheckpointCommand(
+		TEXT("Template.Benchmark.Checkpoint"),
+		TEXT("Times removing and granting every ability set against saving and restoring an ability checkpoint. Args: [Iterations=100]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunCheckpoint));
+}
+
+#endif
@@ -2,6 +2,23 @@
 
 
 #include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "GameplayEffectAggregator.h"
+#include "GameplayAbilitySystem/TemplateAbilityMemoryReport.h"
+#include "GameplayAbilitySystem/TemplateSoakReportSubsystem.h"
+#include "GameTemplate.h"
+
+DECLARE_CYCLE_STAT(TEXT("ApplyGameplayEffectSpecToTargets"), STAT_TemplateAsc_ApplyToTargets, STATGROUP_TemplateAbilitySystem);
+DECLARE_CYCLE_STAT(TEXT("AbilitySystemComponent Tick"), STAT_TemplateAsc_Tick, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Activation Requests"), STAT_TemplateAsc_ServerActivationRequests, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Prediction Rejections"), STAT_TemplateAsc_PredictionRejections, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Ability RPCs"), STAT_TemplateAsc_BatchedRPCs, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Unbatched Ability RPCs"), STAT_TemplateAsc_UnbatchedRPCs, STATGROUP_TemplateAbilitySystem);
+
+static TAutoConsoleVariable<bool> CVarOwnedTagBits(
+	TEXT("Template.AbilitySystem.OwnedTagBits"),
+	true,
+	TEXT("Keeps a bitset of owned tags on every ability system component, used by ability tag requirement checks. Read when actor info is initialized"));
 
 
 void UTemplateAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor)
@@ -11,6 +28,341 @@ void UTemplateAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor,
 	check(InOwnerActor);
 	
 	Super::InitAbilityActorInfo(InOwnerActor, InAvatarActor);
+
+	if (CVarOwnedTagBits.GetValueOnGameThread() && !OwnedTagBitsHandle.IsValid())
+	{
+		RebuildOwnedTagBits();
+		OwnedTagBitsHandle = RegisterGenericGameplayTagEvent().AddUObject(this, &UTemplateAbilitySystemComponent::HandleOwnedTagChanged);
+	}
+}
+
+void UTemplateAbilitySystemComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateAsc_Tick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+void UTemplateAbilitySystemComponent::InternalServerTryActivateAbility(FGameplayAbilitySpecHandle AbilityToActivate,
+	bool InputPressed, const FPredictionKey& PredictionKey, const FGameplayEventData* TriggerEventData)
+{
+	FTemplateAbilityNetCounters* NetCounters = GetNetCounters();
+	if (NetCounters)
+	{
+		++NetCounters->ServerActivationRequests;
+	}
+	INC_DWORD_STAT(STAT_TemplateAsc_ServerActivationRequests);
+
+	if (!bHandlingRPCBatch)
+	{
+		if (NetCounters)
+		{
+			++NetCounters->UnbatchedActivationRPCs;
+		}
+		INC_DWORD_STAT(STAT_TemplateAsc_UnbatchedRPCs);
+	}
+
+	TGuardValue<bool> PredictedActivationGuard(bHandlingPredictedActivation, PredictionKey.IsValidKey());
+	Super::InternalServerTryActivateAbility(AbilityToActivate, InputPressed, PredictionKey, TriggerEventData);
+}
+
+void UTemplateAbilitySystemComponent::NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle,
+	UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
+{
+	++NumActivationFailures;
+
+	if (IsOwnerActorAuthoritative())
+	{
+		FTemplateAbilityNetCounters* NetCounters = GetNetCounters();
+		if (NetCounters)
+		{
+			++NetCounters->ServerActivationFailures;
+		}
+
+		// The client already ran this activation, the server failing it rolls the prediction back
+		if (bHandlingPredictedActivation)
+		{
+			if (NetCounters)
+			{
+				++NetCounters->PredictionRejections;
+			}
+			INC_DWORD_STAT(STAT_TemplateAsc_PredictionRejections);
+		}
+	}
+
+	Super::NotifyAbilityFailed(Handle, Ability, FailureReason);
+}
+
+void UTemplateAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle,
+	UGameplayAbility* Ability)
+{
+	++NumActivations;
+
+	Super::NotifyAbilityActivated(Handle, Ability);
+}
+
+void UTemplateAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
+{
+	// Open a batch for every opted in ability this press may activate, so its activate, target data and end RPCs go out together
+	TArray<TUniquePtr<FScopedServerAbilityRPCBatcher>, TInlineAllocator<4>> RPCBatchers;
+	if (!IsOwnerActorAuthoritative())
+	{
+		ABILITYLIST_SCOPE_LOCK();
+		for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+		{
+			const UTemplateGameplayAbility* Ability = Cast<UTemplateGameplayAbility>(Spec.Ability);
+			if (Spec.InputID == InputID && Ability && Ability->bBatchServerRPCs && !Spec.IsActive())
+			{
+				RPCBatchers.Add(MakeUnique<FScopedServerAbilityRPCBatcher>(this, Spec.Handle));
+			}
+		}
+	}
+
+	Super::AbilityLocalInputPressed(InputID);
+
+	// Each batcher holds a prediction window, close them in reverse order of opening (an array destroys front to back)
+	while (RPCBatchers.Num() > 0)
+	{
+		RPCBatchers.Pop(false);
+	}
+}
+
+void UTemplateAbilitySystemComponent::ServerAbilityRPCBatch_Internal(FServerAbilityRPCBatch& BatchInfo)
+{
+	if (FTemplateAbilityNetCounters* NetCounters = GetNetCounters())
+	{
+		++NetCounters->BatchedRPCs;
+	}
+	INC_DWORD_STAT(STAT_TemplateAsc_BatchedRPCs);
+
+	TGuardValue<bool> RPCBatchGuard(bHandlingRPCBatch, true);
+	Super::ServerAbilityRPCBatch_Internal(BatchInfo);
+}
+
+void UTemplateAbilitySystemComponent::ServerEndAbility_Implementation(FGameplayAbilitySpecHandle AbilityToEnd,
+	FGameplayAbilityActivationInfo ActivationInfo, FPredictionKey PredictionKey)
+{
+	if (!bHandlingRPCBatch)
+	{
+		if (FTemplateAbilityNetCounters* NetCounters = GetNetCounters())
+		{
+			++NetCounters->UnbatchedEndAbilityRPCs;
+		}
+		INC_DWORD_STAT(STAT_TemplateAsc_UnbatchedRPCs);
+	}
+
+	Super::ServerEndAbility_Implementation(AbilityToEnd, ActivationInfo, PredictionKey);
+}
+
+void UTemplateAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	// The authority binds what it grants, clients only learn about specs through replication
+	if (!IsOwnerActorAuthoritative())
+	{
+		OnAbilitySpecGiven.Broadcast(AbilitySpec);
+	}
+}
+
+void UTemplateAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	if (!IsOwnerActorAuthoritative())
+	{
+		OnAbilitySpecRemoved.Broadcast(AbilitySpec);
+	}
+
+	Super::OnRemoveAbility(AbilitySpec);
+}
+
+void UTemplateAbilitySystemComponent::ApplySignificanceBucket(const FTemplateSignificanceBucket& Bucket)
+{
+	SetComponentTickInterval(Bucket.TickInterval);
+
+	// Cues are multicast by the authority, suppressing them there would hide them from every client
+	SetGameplayCueSuppression(Bucket.bSuppressGameplayCues && !IsOwnerActorAuthoritative());
+
+	if (AActor* Owner = GetOwner())
+	{
+		// Someone else changed the frequency since the last bucket, that is the new unthrottled value
+		if (!UnthrottledNetUpdateFrequency.IsSet() || Owner->NetUpdateFrequency != AppliedNetUpdateFrequency)
+		{
+			UnthrottledNetUpdateFrequency = Owner->NetUpdateFrequency;
+		}
+
+		AppliedNetUpdateFrequency = FMath::Min(Bucket.NetUpdateFrequency, UnthrottledNetUpdateFrequency.GetValue());
+		Owner->NetUpdateFrequency = AppliedNetUpdateFrequency;
+	}
+}
+
+void UTemplateAbilitySystemComponent::ResetSignificanceBucket()
+{
+	AActor* Owner = GetOwner();
+	if (Owner && UnthrottledNetUpdateFrequency.IsSet() && Owner->NetUpdateFrequency == AppliedNetUpdateFrequency)
+	{
+		Owner->NetUpdateFrequency = UnthrottledNetUpdateFrequency.GetValue();
+	}
+	UnthrottledNetUpdateFrequency.Reset();
+
+	// Called on the way out, there is nothing to catch up on
+	bSuppressGameplayCues = false;
+	SuppressedEffectCues.Reset();
+	SuppressedLooseCues.Reset();
+}
+
+void UTemplateAbilitySystemComponent::SetGameplayCueSuppression(bool bSuppress)
+{
+	if (bSuppress == bSuppressGameplayCues)
+	{
+		return;
+	}
+
+	if (!bSuppress)
+	{
+		bSuppressGameplayCues = false;
+		CatchUpPersistentGameplayCues();
+		return;
+	}
+
+	// Remember what is shown, only the difference is replayed when suppression stops
+	SuppressedEffectCues.Reset();
+	for (FActiveGameplayEffectsContainer::ConstIterator It = ActiveGameplayEffects.CreateConstIterator(); It; ++It)
+	{
+		const FActiveGameplayEffect& ActiveEffect = *It;
+		if (!ActiveEffect.IsPendingRemove && ActiveEffect.Spec.Def && ActiveEffect.Spec.Def->GameplayCues.Num() > 0)
+		{
+			FGameplayTagContainer& CueTags = SuppressedEffectCues.Add(ActiveEffect.Handle);
+			for (const FGameplayEffectCue& Cue : ActiveEffect.Spec.Def->GameplayCues)
+			{
+				CueTags.AppendTags(Cue.GameplayCueTags);
+			}
+		}
+	}
+
+	SuppressedLooseCues.Reset();
+	for (const FActiveGameplayCueContainer* CueContainer : { &ActiveGameplayCues, &MinimalReplicationGameplayCues })
+	{
+		for (const FActiveGameplayCue& Cue : CueContainer->GameplayCues)
+		{
+			SuppressedLooseCues.Add(Cue.GameplayCueTag);
+		}
+	}
+
+	bSuppressGameplayCues = true;
+}
+
+void UTemplateAbilitySystemComponent::CatchUpPersistentGameplayCues()
+{
+	// Effects added while suppressed start their cues now, effects removed meanwhile end theirs. Executed cues are gone for good
+	TSet<FActiveGameplayEffectHandle> LiveEffects;
+	for (FActiveGameplayEffectsContainer::ConstIterator It = ActiveGameplayEffects.CreateConstIterator(); It; ++It)
+	{
+		const FActiveGameplayEffect& ActiveEffect = *It;
+		if (ActiveEffect.IsPendingRemove || !ActiveEffect.Spec.Def || ActiveEffect.Spec.Def->GameplayCues.Num() == 0)
+		{
+			continue;
+		}
+
+		LiveEffects.Add(ActiveEffect.Handle);
+		if (!SuppressedEffectCues.Contains(ActiveEffect.Handle))
+		{
+			const FGameplayEffectSpecForRPC SpecForRPC(ActiveEffect.Spec);
+			InvokeGameplayCueEvent(SpecForRPC, EGameplayCueEvent::OnActive);
+			InvokeGameplayCueEvent(SpecForRPC, EGameplayCueEvent::WhileActive);
+		}
+	}
+
+	for (const auto& SuppressedEffect : SuppressedEffectCues)
+	{
+		if (!LiveEffects.Contains(SuppressedEffect.Key))
+		{
+			for (const FGameplayTag& CueTag : SuppressedEffect.Value)
+			{
+				InvokeGameplayCueEvent(CueTag, EGameplayCueEvent::Removed);
+			}
+		}
+	}
+
+	// Same for cues added without an effect
+	TArray<FGameplayTag, TInlineAllocator<8>> LiveLooseCues;
+	for (const FActiveGameplayCueContainer* CueContainer : { &ActiveGameplayCues, &MinimalReplicationGameplayCues })
+	{
+		for (const FActiveGameplayCue& Cue : CueContainer->GameplayCues)
+		{
+			LiveLooseCues.Add(Cue.GameplayCueTag);
+			if (!SuppressedLooseCues.Contains(Cue.GameplayCueTag))
+			{
+				InvokeGameplayCueEvent(Cue.GameplayCueTag, EGameplayCueEvent::OnActive, Cue.Parameters);
+				InvokeGameplayCueEvent(Cue.GameplayCueTag, EGameplayCueEvent::WhileActive, Cue.Parameters);
+			}
+		}
+	}
+
+	for (const FGameplayTag& CueTag : SuppressedLooseCues)
+	{
+		if (!LiveLooseCues.Contains(CueTag))
+		{
+			InvokeGameplayCueEvent(CueTag, EGameplayCueEvent::Removed);
+		}
+	}
+
+	SuppressedEffectCues.Reset();
+	SuppressedLooseCues.Reset();
+}
+
+void UTemplateAbilitySystemComponent::AccumulateMemoryUsage(FTemplateAbilityMemoryUsage& Usage) const
+{
+	Usage.AbilitySystemComponent += GetClass()->GetStructureSize() + OwnedTagBits.GetAllocatedSize();
+
+	Usage.ActivatableAbilities += ActivatableAbilities.Items.GetAllocatedSize();
+	for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		Usage.ActivatableAbilities += Spec.ReplicatedInstances.GetAllocatedSize() + Spec.NonReplicatedInstances.GetAllocatedSize();
+		for (const UGameplayAbility* Instance : Spec.GetAbilityInstances())
+		{
+			Usage.ActivatableAbilities += Instance ? Instance->GetClass()->GetStructureSize() : 0;
+		}
+	}
+
+	Usage.ActiveEffects += ActiveGameplayEffects.GetNumGameplayEffects() * sizeof(FActiveGameplayEffect);
+
+	for (const UAttributeSet* AttributeSet : GetSpawnedAttributes())
+	{
+		Usage.AttributeSets += AttributeSet ? AttributeSet->GetClass()->GetStructureSize() : 0;
+	}
+}
+
+const FTemplateGameplayTagBits* UTemplateAbilitySystemComponent::GetOwnedTagBits() const
+{
+	if (!OwnedTagBitsHandle.IsValid())
+	{
+		return nullptr;
+	}
+
+	if (OwnedTagBits.IsStale())
+	{
+		RebuildOwnedTagBits();
+	}
+	return OwnedTagBits.IsComplete() ? &OwnedTagBits : nullptr;
+}
+
+void UTemplateAbilitySystemComponent::HandleOwnedTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	// Only fires when a tag starts or stops being owned
+	OwnedTagBits.SetTag(Tag, NewCount > 0);
+}
+
+void UTemplateAbilitySystemComponent::RebuildOwnedTagBits() const
+{
+	FGameplayTagContainer OwnedTags;
+	GetOwnedGameplayTags(OwnedTags);
+
+	OwnedTagBits.Reset();
+	for (const FGameplayTag& Tag : OwnedTags)
+	{
+		OwnedTagBits.AddTagAndParents(Tag);
+	}
 }
 
 void UTemplateAbilitySystemComponent::GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer,
@@ -31,3 +383,112 @@ void UTemplateAbilitySystemComponent::GetActiveAbilitiesWithTags(const FGameplay
 		}	
 	}
 }
+
+FGameplayEffectSpecHandle UTemplateAbilitySystemComponent::MakeOutgoingSpecFromPrototype(const FGameplayEffectSpec& Prototype)
+{
+	// The prototype's context is invalid, so SetContext won't capture anything: capture source tags, attributes and duration explicitly
+	FGameplayEffectSpec* NewSpec = new FGameplayEffectSpec(Prototype);
+	NewSpec->SetContext(MakeEffectContext());
+	NewSpec->CaptureDataFromSource();
+
+	return FGameplayEffectSpecHandle(NewSpec);
+}
+
+void UTemplateAbilitySystemComponent::ApplyGameplayEffectSpecsToSelf(TConstArrayView<FGameplayEffectSpecHandle> SpecHandles,
+	TArray<FActiveGameplayEffectHandle>& OutEffectHandles)
+{
+	OutEffectHandles.Reserve(OutEffectHandles.Num() + SpecHandles.Num());
+
+	// Defer aggregator OnDirty callbacks until every spec has been applied
+	FScopedAggregatorOnDirtyBatch AggregatorBatch;
+
+	for (const FGameplayEffectSpecHandle& SpecHandle : SpecHandles)
+	{
+		if (SpecHandle.IsValid())
+		{
+			OutEffectHandles.Add(ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get()));
+		}
+	}
+}
+
+void UTemplateAbilitySystemComponent::ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpec& Spec,
+	TConstArrayView<UAbilitySystemComponent*> Targets, TArray<FActiveGameplayEffectHandle>& OutEffectHandles)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateAsc_ApplyToTargets);
+
+	OutEffectHandles.Reserve(OutEffectHandles.Num() + Targets.Num());
+
+	// Defer aggregator OnDirty callbacks until the spec has reached every target
+	FScopedAggregatorOnDirtyBatch AggregatorBatch;
+
+	for (UAbilitySystemComponent* Target : Targets)
+	{
+		if (IsValid(Target))
+		{
+			OutEffectHandles.Add(ApplyGameplayEffectSpecToTarget(Spec, Target, ScopedPredictionKey));
+		}
+	}
+}
+
+void UTemplateAbilitySystemComponent::ApplyGameplayEffectToTargets(TSubclassOf<UGameplayEffect> GameplayEffectClass,
+	float Level, TConstArrayView<UAbilitySystemComponent*> Targets, TArray<FActiveGameplayEffectHandle>& OutEffectHandles)
+{
+	if (!IsValid(GameplayEffectClass))
+	{
+		return;
+	}
+
+	// One spec and one context, shared by every target
+	const FGameplayEffectSpecHandle SpecHandle = MakeOutgoingSpec(GameplayEffectClass, Level, MakeEffectContext());
+	if (SpecHandle.IsValid())
+	{
+		ApplyGameplayEffectSpecToTargets(*SpecHandle.Data.Get(), Targets, OutEffectHandles);
+	}
+}
+
+void UTemplateAbilitySystemComponent::QueueAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	// Keep the first old value and the last new value of each attribute
+	if (FTemplateAttributeChange* PendingChange = PendingAttributeChanges.FindByPredicate([&Attribute](const FTemplateAttributeChange& Change) { return Change.Attribute == Attribute; }))
+	{
+		PendingChange->NewValue = NewValue;
+	}
+	else
+	{
+		PendingAttributeChanges.Add({ Attribute, OldValue, NewValue });
+	}
+
+	if (!bAttributeChangeDispatchQueued)
+	{
+		UWorld* World = GetWorld();
+		if (!World)
+		{
+			DispatchAttributeChanges();
+			return;
+		}
+
+		bAttributeChangeDispatchQueued = true;
+		World->GetTimerManager().SetTimerForNextTick(this, &UTemplateAbilitySystemComponent::DispatchAttributeChanges);
+	}
+}
+
+FTemplateAbilityNetCounters* UTemplateAbilitySystemComponent::GetNetCounters() const
+{
+	const UWorld* World = GetWorld();
+	UTemplateSoakReportSubsystem* SoakReportSubsystem = World ? World->GetSubsystem<UTemplateSoakReportSubsystem>() : nullptr;
+	return SoakReportSubsystem ? &SoakReportSubsystem->GetNetCounters() : nullptr;
+}
+
+void UTemplateAbilitySystemComponent::DispatchAttributeChanges()
+{
+	bAttributeChangeDispatchQueued = false;
+
+	// Listeners may change attributes again, those changes go out next frame
+	TArray<FTemplateAttributeChange> Changes = MoveTemp(PendingAttributeChanges);
+	Changes.RemoveAllSwap([](const FTemplateAttributeChange& Change) { return Change.OldValue == Change.NewValue; });
+
+	if (Changes.Num() > 0)
+	{
+		OnAttributesChanged.Broadcast(this, Changes);
+	}
+}
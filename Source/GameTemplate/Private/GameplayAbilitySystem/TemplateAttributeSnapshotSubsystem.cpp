@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateAttributeSnapshotSubsystem.h"
+
+#include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
+#include <limits>
+
+namespace AttributeSnapshotImpl
+{
+	// NaN fails every comparison, so free slots never match a query
+	constexpr float MissingValue = std::numeric_limits<float>::quiet_NaN();
+
+	static float ReadValue(const UTemplateAbilitySystemComponent* Asc, const FGameplayAttribute& Attribute)
+	{
+		return Asc->HasAttributeSetForAttribute(Attribute) ? Asc->GetNumericAttribute(Attribute) : MissingValue;
+	}
+}
+
+void UTemplateAttributeSnapshotSubsystem::TrackAttribute(const FGameplayAttribute& Attribute)
+{
+	using namespace AttributeSnapshotImpl;
+
+	if (!Attribute.IsValid() || Columns.ContainsByPredicate([&Attribute](const FAttributeColumn& Candidate) { return Candidate.Attribute == Attribute; }))
+	{
+		return;
+	}
+
+	const int32 ColumnIndex = Columns.AddDefaulted();
+	FAttributeColumn& Column = Columns[ColumnIndex];
+	Column.Attribute = Attribute;
+	Column.Values.Init(MissingValue, Slots.Num());
+
+	// Backfill already registered ability systems
+	for (int32 Slot = 0; Slot < Slots.Num(); ++Slot)
+	{
+		if (Slots[Slot].IsValid())
+		{
+			BindColumn(ColumnIndex, Slot);
+		}
+	}
+}
+
+int32 UTemplateAttributeSnapshotSubsystem::RegisterAbilitySystem(UTemplateAbilitySystemComponent* Asc)
+{
+	using namespace AttributeSnapshotImpl;
+
+	check(Asc);
+	if (const int32* ExistingSlot = SlotByAbilitySystem.Find(Asc))
+	{
+		return *ExistingSlot;
+	}
+
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+		Slots[Slot] = Asc;
+	}
+	else
+	{
+		Slot = Slots.Add(Asc);
+		SlotDelegateHandles.AddDefaulted();
+		for (FAttributeColumn& Column : Columns)
+		{
+			Column.Values.Add(MissingValue);
+		}
+	}
+
+	SlotByAbilitySystem.Add(Asc, Slot);
+	SlotDelegateHandles[Slot].SetNum(Columns.Num());
+
+	for (int32 ColumnIndex = 0; ColumnIndex < Columns.Num(); ++ColumnIndex)
+	{
+		BindColumn(ColumnIndex, Slot);
+	}
+
+	return Slot;
+}
+
+void UTemplateAttributeSnapshotSubsystem::UnregisterAbilitySystem(UTemplateAbilitySystemComponent* Asc)
+{
+	int32 Slot = INDEX_NONE;
+	if (!SlotByAbilitySystem.RemoveAndCopyValue(Asc, Slot))
+	{
+		return;
+	}
+
+	UnbindSlot(Slot);
+	FreeSlots.Add(Slot);
+}
+
+TConstArrayView<float> UTemplateAttributeSnapshotSubsystem::GetAttributeValues(const FGameplayAttribute& Attribute) const
+{
+	const FAttributeColumn* Column = Columns.FindByPredicate([&Attribute](const FAttributeColumn& Candidate) { return Candidate.Attribute == Attribute; });
+	return Column ? TConstArrayView<float>(Column->Values) : TConstArrayView<float>();
+}
+
+UTemplateAbilitySystemComponent* UTemplateAttributeSnapshotSubsystem::GetAbilitySystemAtSlot(int32 Slot) const
+{
+	return Slots.IsValidIndex(Slot) ? Slots[Slot].Get() : nullptr;
+}
+
+void UTemplateAttributeSnapshotSubsystem::GatherSlotsBelow(const FGameplayAttribute& Attribute, float Threshold,
+	TArray<int32>& OutSlots) const
+{
+	const TConstArrayView<float> Values = GetAttributeValues(Attribute);
+	const float* RESTRICT ValueData = Values.GetData();
+
+	// Plain linear scan over one contiguous column
+	for (int32 Slot = 0; Slot < Values.Num(); ++Slot)
+	{
+		if (ValueData[Slot] < Threshold)
+		{
+			OutSlots.Add(Slot);
+		}
+	}
+}
+
+void UTemplateAttributeSnapshotSubsystem::GatherAbilitySystemsBelow(const FGameplayAttribute& Attribute, float Threshold,
+	TArray<UTemplateAbilitySystemComponent*>& OutAbilitySystems) const
+{
+	TArray<int32> MatchingSlots;
+	GatherSlotsBelow(Attribute, Threshold, MatchingSlots);
+
+	OutAbilitySystems.Reserve(OutAbilitySystems.Num() + MatchingSlots.Num());
+	for (const int32 Slot : MatchingSlots)
+	{
+		if (UTemplateAbilitySystemComponent* Asc = Slots[Slot].Get())
+		{
+			OutAbilitySystems.Add(Asc);
+		}
+	}
+}
+
+void UTemplateAttributeSnapshotSubsystem::Deinitialize()
+{
+	for (int32 Slot = 0; Slot < Slots.Num(); ++Slot)
+	{
+		UnbindSlot(Slot);
+	}
+
+	Columns.Reset();
+	Slots.Reset();
+	SlotDelegateHandles.Reset();
+	FreeSlots.Reset();
+	SlotByAbilitySystem.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTemplateAttributeSnapshotSubsystem::BindColumn(int32 ColumnIndex, int32 Slot)
+{
+	UTemplateAbilitySystemComponent* Asc = Slots[Slot].Get();
+	check(Asc);
+
+	FAttributeColumn& Column = Columns[ColumnIndex];
+	Column.Values[Slot] = AttributeSnapshotImpl::ReadValue(Asc, Column.Attribute);
+
+	TArray<FDelegateHandle>& DelegateHandles = SlotDelegateHandles[Slot];
+	DelegateHandles.SetNum(Columns.Num());
+	DelegateHandles[ColumnIndex] = Asc->GetGameplayAttributeValueChangeDelegate(Column.Attribute)
+		.AddUObject(this, &UTemplateAttributeSnapshotSubsystem::HandleAttributeChanged, ColumnIndex, Slot);
+}
+
+void UTemplateAttributeSnapshotSubsystem::UnbindSlot(int32 Slot)
+{
+	UTemplateAbilitySystemComponent* Asc = Slots[Slot].Get();
+
+	TArray<FDelegateHandle>& DelegateHandles = SlotDelegateHandles[Slot];
+	for (int32 ColumnIndex = 0; ColumnIndex < DelegateHandles.Num(); ++ColumnIndex)
+	{
+		if (Asc && DelegateHandles[ColumnIndex].IsValid())
+		{
+			Asc->GetGameplayAttributeValueChangeDelegate(Columns[ColumnIndex].Attribute).Remove(DelegateHandles[ColumnIndex]);
+		}
+	}
+	DelegateHandles.Reset();
+
+	for (FAttributeColumn& Column : Columns)
+	{
+		Column.Values[Slot] = AttributeSnapshotImpl::MissingValue;
+	}
+
+	Slots[Slot].Reset();
+}
+
+void UTemplateAttributeSnapshotSubsystem::HandleAttributeChanged(const FOnAttributeChangeData& ChangeData,
+	int32 ColumnIndex, int32 Slot)
+{
+	Columns[ColumnIndex].Values[Slot] = ChangeData.NewValue;
+}
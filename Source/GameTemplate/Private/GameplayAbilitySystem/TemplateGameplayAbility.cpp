@@ -35,3 +35,44 @@ void UTemplateGameplayAbility::OnRemoveAbility(const FGameplayAbilityActorInfo*
 	Super::OnRemoveAbility(ActorInfo, Spec);
 	OnAbilityRemoved();
 }
+
+bool UTemplateGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySystemComponent& AbilitySystemComponent,
+	const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags, FGameplayTagContainer* OptionalRelevantTags) const
+{
+	// Fast path when only owned tags are checked, the engine copies and matches the owned tag container instead
+	const UTemplateAbilitySystemComponent* TemplateAsc = Cast<UTemplateAbilitySystemComponent>(&AbilitySystemComponent);
+	const FTemplateGameplayTagBits* OwnedTagBits = TemplateAsc ? TemplateAsc->GetOwnedTagBits() : nullptr;
+
+	if (OwnedTagBits && SourceRequiredTags.IsEmpty() && SourceBlockedTags.IsEmpty() && TargetRequiredTags.IsEmpty() && TargetBlockedTags.IsEmpty())
+	{
+		// Built again when the tag tree changed, net indices change with it
+		if (!ActivationRequiredTagBits.IsSet() || ActivationRequiredTagBits->IsStale())
+		{
+			ActivationRequiredTagBits = FTemplateGameplayTagBits::MakeQuery(ActivationRequiredTags);
+			ActivationBlockedTagBits = FTemplateGameplayTagBits::MakeQuery(ActivationBlockedTags);
+		}
+
+		// Tags without a net index can't be checked with bits, the engine checks them
+		if (ActivationRequiredTagBits->IsComplete() && ActivationBlockedTagBits->IsComplete()
+			&& !AbilitySystemComponent.AreAbilityTagsBlocked(AbilityTags)
+			&& OwnedTagBits->HasAll(ActivationRequiredTagBits.GetValue())
+			&& !OwnedTagBits->HasAny(ActivationBlockedTagBits.GetValue()))
+		{
+			return true;
+		}
+	}
+
+	// Failures go through the engine, which also reports the relevant tags
+	return Super::DoesAbilitySatisfyTagRequirements(AbilitySystemComponent, SourceTags, TargetTags, OptionalRelevantTags);
+}
+
+#if WITH_EDITOR
+void UTemplateGameplayAbility::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Tag requirements may have changed, build the queries again on next use
+	ActivationRequiredTagBits.Reset();
+	ActivationBlockedTagBits.Reset();
+}
+#endif
@@ -4,10 +4,14 @@
 #include "GameplayAbilitySystem/TemplateGameplayAbilitySet.h"
 
 #include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
-#include "Gametemplate/GameTemplate.h"
+#include "GameTemplate.h"
+#include "InputMappingContext.h"
 #include "Player/GameTemplateCharacter.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UObjectIterator.h"
 
-void UTemplateGameplayAbilitySet::GiveAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter)
+void UTemplateGameplayAbilitySet::GiveAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter,
+	FTemplateAbilitySetGrantedHandles& OutGrantedHandles)
 {
 	check(Asc);
 	if (!Asc->IsOwnerActorAuthoritative())
@@ -16,63 +20,92 @@ void UTemplateGameplayAbilitySet::GiveAbilities(UTemplateAbilitySystemComponent*
 		return;
 	}
 
-	// Grant the gameplay attributes
-	for (const FAttributeBindInfo& AttributeBindInfo : Attributes)
+	GrantAttributesAndAbilities(Asc, PlayerCharacter, {}, OutGrantedHandles);
+
+	const FTemplateAbilitySetGrantData& Data = GetGrantData();
+
+	// Grant the gameplay effects
+	TArray<FGameplayEffectSpecHandle> EffectSpecs;
+	EffectSpecs.Reserve(Data.Effects.Num());
+
+	for (const FTemplateAbilitySetGrantData::FEffectEntry& EffectEntry : Data.Effects)
 	{
-		if (!IsValid(AttributeBindInfo.AttributeSet))
-		{
-			UE_LOG(ProjectLog, Error, TEXT("GrantedGameplayAttribute on ability set [%s] is not valid"), *GetNameSafe(this));
-			continue;
-		}
+		EffectSpecs.Add(EffectEntry.Prototype.IsValid()
+			? Asc->MakeOutgoingSpecFromPrototype(*EffectEntry.Prototype)
+			: Asc->MakeOutgoingSpec(EffectEntry.EffectClass, EffectEntry.EffectLevel, Asc->MakeEffectContext()));
+	}
 
-		UAttributeSet* NewSet = NewObject<UAttributeSet>(Asc->GetOwner(), AttributeBindInfo.AttributeSet);
-		Asc->AddAttributeSetSubobject(NewSet);
+	TArray<FActiveGameplayEffectHandle> GameplayEffectHandles;
+	Asc->ApplyGameplayEffectSpecsToSelf(EffectSpecs, GameplayEffectHandles);
 
-		AddAttributeSet(NewSet);
+	for (const FActiveGameplayEffectHandle& GameplayEffectHandle : GameplayEffectHandles)
+	{
+		OutGrantedHandles.AddEffectSpecHandles(GameplayEffectHandle);
 	}
+}
 
-	// Grant the gameplay abilities
-	for (const FAbilityBindInfo& AbilityBindInfo : Abilities)
+void UTemplateGameplayAbilitySet::RestoreAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter,
+	TConstArrayView<FTemplateAbilityCheckpoint::FAbilityState> AbilityStates, FTemplateAbilitySetGrantedHandles& OutGrantedHandles)
+{
+	check(Asc);
+	if (!Asc->IsOwnerActorAuthoritative())
 	{
-		if (AbilityBindInfo.AbilityClass.IsNull())
-		{
-			UE_LOG(ProjectLog, Error, TEXT("GrantedGameplayAbility on ability set [%s] is not valid"), *GetNameSafe(this));
-			continue;
-		}
+		// Must be authoritative to give or take ability sets
+		return;
+	}
 
-		UTemplateGameplayAbility* AbilityCDO = AbilityBindInfo.AbilityClass.LoadSynchronous()->GetDefaultObject<UTemplateGameplayAbility>();
+	GrantAttributesAndAbilities(Asc, PlayerCharacter, AbilityStates, OutGrantedHandles);
+}
 
-		FGameplayAbilitySpec AbilitySpec(AbilityCDO,AbilityBindInfo.AbilityLevel);
+void UTemplateGameplayAbilitySet::GrantAttributesAndAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter,
+	TConstArrayView<FTemplateAbilityCheckpoint::FAbilityState> AbilityStates, FTemplateAbilitySetGrantedHandles& OutGrantedHandles)
+{
+	const FTemplateAbilitySetGrantData& Data = GetGrantData();
 
-		const FGameplayAbilitySpecHandle AbilitySpecHandle = Asc->GiveAbility(AbilitySpec);
+	// Grant the gameplay attributes
+	for (const TSubclassOf<UAttributeSet>& AttributeSetClass : Data.AttributeSets)
+	{
+		UAttributeSet* NewSet = NewObject<UAttributeSet>(Asc->GetOwner(), AttributeSetClass);
+		Asc->AddAttributeSetSubobject(NewSet);
 
-		AddAbilitySpecHandles(AbilitySpecHandle);
-		AddAbilitiesSpec(AbilitySpec);
+		OutGrantedHandles.AddAttributeSet(NewSet);
+	}
 
-		// Bind ability to the input
-		BindAbility(PlayerCharacter,AbilitySpec);
+	// States are stored in baked table order, a set changed since the checkpoint was taken uses the table's levels
+	if (AbilityStates.Num() > 0 && AbilityStates.Num() != Data.Abilities.Num())
+	{
+		UE_LOG(ProjectLog, Warning, TEXT("Checkpoint of ability set [%s] has %d abilities, the set grants %d"), *GetNameSafe(this), AbilityStates.Num(), Data.Abilities.Num());
+		AbilityStates = {};
 	}
 
-	// Grant the gameplay effects
-	for (const FEffectBindInfo& EffectBindInfo : Effects)
+	// Grant the gameplay abilities
+	for (int32 Index = 0; Index < Data.Abilities.Num(); ++Index)
 	{
-		if (!IsValid(EffectBindInfo.GameplayEffect))
+		const FTemplateAbilitySetGrantData::FAbilityEntry& AbilityEntry = Data.Abilities[Index];
+
+		// The set is the source object, it replicates with the spec so clients can find the spec's input action
+		FGameplayAbilitySpec AbilitySpec(AbilityEntry.AbilityCDO, AbilityEntry.AbilityLevel, INDEX_NONE, this);
+		if (AbilityStates.IsValidIndex(Index))
 		{
-			UE_LOG(ProjectLog, Error, TEXT("GrantedGameplayEffect on ability set [%s] is not valid"), *GetNameSafe(this));
-			continue;
+			AbilitySpec.Level = AbilityStates[Index].Level;
+			AbilitySpec.InputID = AbilityStates[Index].InputID;
 		}
 
-		const UGameplayEffect* GameplayEffect = EffectBindInfo.GameplayEffect->GetDefaultObject<UGameplayEffect>();
-		const FActiveGameplayEffectHandle GameplayEffectHandle = Asc->ApplyGameplayEffectToSelf(GameplayEffect, EffectBindInfo.EffectLevel, Asc->MakeEffectContext()); 
+		const FGameplayAbilitySpecHandle AbilitySpecHandle = Asc->GiveAbility(AbilitySpec);
 
-		AddEffectSpecHandles(GameplayEffectHandle);
-	}
+		OutGrantedHandles.AddAbilitySpecHandles(AbilitySpecHandle);
+		OutGrantedHandles.AddAbilitiesSpec(AbilitySpec);
 
-	
+		// Bind ability to the input
+		if (FGameplayAbilitySpec* GrantedSpec = Asc->FindAbilitySpecFromHandle(AbilitySpecHandle))
+		{
+			BindAbility(PlayerCharacter, AbilityEntry, *GrantedSpec);
+		}
+	}
 }
 
 void UTemplateGameplayAbilitySet::RemoveAbilities(UTemplateAbilitySystemComponent* Asc,
-	AGameTemplateCharacter* PlayerCharacter)
+	AGameTemplateCharacter* PlayerCharacter, FTemplateAbilitySetGrantedHandles& GrantedHandles) const
 {
 	if (!Asc->IsOwnerActorAuthoritative())
 	{
@@ -80,51 +113,301 @@ void UTemplateGameplayAbilitySet::RemoveAbilities(UTemplateAbilitySystemComponen
 		return;
 	}
 
-	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : AbilitySpecHandles)
+	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : GrantedHandles.AbilitySpecHandles)
 	{
-		// @TODO: Remove this debug print
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("We're removing abilities, which was previously saved as handle."));
 		Asc->ClearAbility(AbilitySpecHandle);
 	}
 
-	for (FGameplayAbilitySpec& AbilitySpec : AbilitiesSpec)
+	for (FGameplayAbilitySpec& AbilitySpec : GrantedHandles.AbilitiesSpec)
 	{
-		// @TODO: Remove this debug print
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Ability has been unbound from input."));
 		UnbindAbility(PlayerCharacter,AbilitySpec);
 	}
 
-	for (FActiveGameplayEffectHandle& EffectSpecHandle : EffectSpecHandles)
+	for (FActiveGameplayEffectHandle& EffectSpecHandle : GrantedHandles.EffectSpecHandles)
 	{
-		// @TODO: Remove this debug print
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("We're removing effects, which was previously saved as handle."));
 		Asc->RemoveActiveGameplayEffect(EffectSpecHandle);
 	}
 
-	for (UAttributeSet* AttributeSet : GrantedAttributeSets)
+	for (UAttributeSet* AttributeSet : GrantedHandles.GrantedAttributeSets)
 	{
-		// @TODO: Remove this debug print
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Attribute has been removed."));
 		Asc->RemoveSpawnedAttribute(AttributeSet);
 	}
 	
-	AbilitySpecHandles.Reset();
-	EffectSpecHandles.Reset();
-	AbilitiesSpec.Reset();
-	GrantedAttributeSets.Reset();
+	GrantedHandles.Reset();
 }
 
-void UTemplateGameplayAbilitySet::BindAbility(AGameTemplateCharacter* PlayerCharacter, FGameplayAbilitySpec& Spec) const
+const FTemplateAbilitySetGrantData& UTemplateGameplayAbilitySet::GetGrantData()
 {
-	check(Spec.Ability);
-	check(PlayerCharacter);
+	if (GrantData.IsSet())
+	{
+		return GrantData.GetValue();
+	}
+
+#if WITH_EDITOR
+	// Compiling a Blueprint replaces the class defaults the runtime data points at
+	static const FDelegateHandle ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddStatic(&UTemplateGameplayAbilitySet::HandleObjectsReplaced);
+
+	// Entries changed since the set was last saved, bake them again in memory
+	if (BakedTable.SourceHash != ComputeSourceHash())
+	{
+		TArray<FText> Errors;
+		if (!BakeTable(Errors))
+		{
+			for (const FText& Error : Errors)
+			{
+				UE_LOG(ProjectLog, Error, TEXT("%s"), *Error.ToString());
+			}
+		}
+	}
+#endif
+
+	// The table is validated when baked, a grant only walks it
+	FTemplateAbilitySetGrantData& Data = GrantData.Emplace();
+	Data.AttributeSets = BakedTable.AttributeSets;
+	Data.InputMappingContexts = BakedTable.InputMappingContexts;
+
+	Data.Abilities.Reserve(BakedTable.Abilities.Num());
+	for (const FTemplateBakedAbilityEntry& BakedAbility : BakedTable.Abilities)
+	{
+		FTemplateAbilitySetGrantData::FAbilityEntry& AbilityEntry = Data.Abilities.AddDefaulted_GetRef();
+		AbilityEntry.AbilityCDO = BakedAbility.AbilityClass->GetDefaultObject<UTemplateGameplayAbility>();
+		AbilityEntry.AbilityLevel = BakedAbility.AbilityLevel;
+		AbilityEntry.InputAction = BakedAbility.InputAction;
+		AbilityEntry.InputBufferTime = BakedAbility.InputBufferTime;
+	}
+
+	Data.Effects.Reserve(BakedTable.Effects.Num());
+	for (const FEffectBindInfo& BakedEffect : BakedTable.Effects)
+	{
+		FTemplateAbilitySetGrantData::FEffectEntry& EffectEntry = Data.Effects.AddDefaulted_GetRef();
+		EffectEntry.EffectClass = BakedEffect.GameplayEffect;
+		EffectEntry.EffectLevel = BakedEffect.EffectLevel;
+
+		// Conditional effects are picked from the source tags and built with the context when the spec is initialized,
+		// a prototype without either would pick them wrong and share them between every clone
+		const UGameplayEffect* GameplayEffect = BakedEffect.GameplayEffect->GetDefaultObject<UGameplayEffect>();
+		if (GameplayEffect->ConditionalGameplayEffects.Num() == 0)
+		{
+			// Built without a context, each clone gets the owning ASC's context and captures its source data when granted
+			EffectEntry.Prototype = MakeShared<FGameplayEffectSpec>(GameplayEffect, FGameplayEffectContextHandle(), BakedEffect.EffectLevel);
+		}
+	}
+
+	return Data;
+}
+
+#if WITH_EDITOR
+void UTemplateGameplayAbilitySet::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
 
-	for (const FAbilityBindInfo& BindInfo : Abilities)
+	TArray<FText> Errors;
+	if (!BakeTable(Errors))
 	{
-		if (BindInfo.AbilityClass.LoadSynchronous() == Spec.Ability->GetClass())
+		// A regular save only warns so work in progress can still be saved
+		for (const FText& Error : Errors)
 		{
-			PlayerCharacter->SetInputBinding(BindInfo.InputAction.LoadSynchronous(),Spec);
+			if (ObjectSaveContext.IsCooking())
+			{
+				UE_LOG(ProjectLog, Error, TEXT("%s"), *Error.ToString());
+			}
+			else
+			{
+				UE_LOG(ProjectLog, Warning, TEXT("%s"), *Error.ToString());
+			}
 		}
+
+		// Cooking with entries dropped is a failure, not a log line
+		ensureAlwaysMsgf(!ObjectSaveContext.IsCooking(), TEXT("Ability set [%s] has %d invalid entries and can't be cooked"), *GetPathName(), Errors.Num());
+	}
+}
+
+EDataValidationResult UTemplateGameplayAbilitySet::IsDataValid(TArray<FText>& ValidationErrors)
+{
+	EDataValidationResult Result = Super::IsDataValid(ValidationErrors);
+
+	// Validation only reports, the table is baked when the set is saved
+	FTemplateAbilitySetBakedTable Table;
+	TArray<FText> Errors;
+	if (!BuildBakedTable(Table, Errors))
+	{
+		ValidationErrors.Append(Errors);
+		Result = EDataValidationResult::Invalid;
+	}
+
+	return Result;
+}
+
+void UTemplateGameplayAbilitySet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Entries changed, the stale hash makes the next grant bake them again
+	GrantData.Reset();
+}
+
+bool UTemplateGameplayAbilitySet::BakeTable(TArray<FText>& OutErrors)
+{
+	FTemplateAbilitySetBakedTable Table;
+	const bool bValid = BuildBakedTable(Table, OutErrors);
+
+	BakedTable = MoveTemp(Table);
+	return bValid;
+}
+
+bool UTemplateGameplayAbilitySet::BuildBakedTable(FTemplateAbilitySetBakedTable& Table, TArray<FText>& OutErrors) const
+{
+	const int32 NumErrors = OutErrors.Num();
+	Table = FTemplateAbilitySetBakedTable();
+
+	for (int32 Index = 0; Index < Attributes.Num(); ++Index)
+	{
+		const FAttributeBindInfo& AttributeBindInfo = Attributes[Index];
+		if (!IsValid(AttributeBindInfo.AttributeSet))
+		{
+			OutErrors.Add(FText::FromString(FString::Printf(TEXT("GrantedGameplayAttribute %d on ability set [%s] is not valid"), Index, *GetNameSafe(this))));
+			continue;
+		}
+
+		Table.AttributeSets.Add(AttributeBindInfo.AttributeSet);
+	}
+
+	for (int32 Index = 0; Index < Abilities.Num(); ++Index)
+	{
+		const FAbilityBindInfo& AbilityBindInfo = Abilities[Index];
+
+		UClass* AbilityClass = AbilityBindInfo.AbilityClass.LoadSynchronous();
+		if (!AbilityClass)
+		{
+			OutErrors.Add(FText::FromString(FString::Printf(TEXT("GrantedGameplayAbility %d on ability set [%s] is not valid"), Index, *GetNameSafe(this))));
+			continue;
+		}
+
+		// Abilities without input are fine, an input action that doesn't load is not
+		UInputAction* InputAction = AbilityBindInfo.InputAction.LoadSynchronous();
+		if (!InputAction && !AbilityBindInfo.InputAction.IsNull())
+		{
+			OutErrors.Add(FText::FromString(FString::Printf(TEXT("InputAction [%s] of ability %d on ability set [%s] can't be loaded"), *AbilityBindInfo.InputAction.ToString(), Index, *GetNameSafe(this))));
+			continue;
+		}
+
+		FTemplateBakedAbilityEntry& BakedAbility = Table.Abilities.AddDefaulted_GetRef();
+		BakedAbility.AbilityClass = AbilityClass;
+		BakedAbility.AbilityLevel = AbilityBindInfo.AbilityLevel;
+		BakedAbility.InputAction = InputAction;
+		BakedAbility.InputBufferTime = AbilityBindInfo.InputBufferTime;
+	}
+
+	for (int32 Index = 0; Index < Effects.Num(); ++Index)
+	{
+		const FEffectBindInfo& EffectBindInfo = Effects[Index];
+		if (!IsValid(EffectBindInfo.GameplayEffect))
+		{
+			OutErrors.Add(FText::FromString(FString::Printf(TEXT("GrantedGameplayEffect %d on ability set [%s] is not valid"), Index, *GetNameSafe(this))));
+			continue;
+		}
+
+		Table.Effects.Add(EffectBindInfo);
+	}
+
+	for (int32 Index = 0; Index < InputMappingContexts.Num(); ++Index)
+	{
+		const FMappingContextBindInfo& MappingContextBindInfo = InputMappingContexts[Index];
+
+		UInputMappingContext* MappingContext = MappingContextBindInfo.MappingContext.LoadSynchronous();
+		if (!MappingContext)
+		{
+			OutErrors.Add(FText::FromString(FString::Printf(TEXT("InputMappingContext %d on ability set [%s] is not valid"), Index, *GetNameSafe(this))));
+			continue;
+		}
+
+		FTemplateBakedMappingContextEntry& BakedMappingContext = Table.InputMappingContexts.AddDefaulted_GetRef();
+		BakedMappingContext.MappingContext = MappingContext;
+		BakedMappingContext.Priority = MappingContextBindInfo.Priority;
+	}
+
+	Table.SourceHash = ComputeSourceHash();
+
+	return OutErrors.Num() == NumErrors;
+}
+
+uint32 UTemplateGameplayAbilitySet::ComputeSourceHash() const
+{
+	// Only stable values (paths, not names or pointers), the hash is saved with the set
+	constexpr uint32 BakedTableVersion = 2;
+	uint32 Hash = FCrc::MemCrc32(&BakedTableVersion, sizeof(BakedTableVersion));
+
+	auto HashPath = [&Hash](const FSoftObjectPath& Path)
+	{
+		Hash = FCrc::StrCrc32(*Path.ToString(), Hash);
+	};
+
+	for (const FAttributeBindInfo& AttributeBindInfo : Attributes)
+	{
+		HashPath(FSoftObjectPath(AttributeBindInfo.AttributeSet.Get()));
+	}
+
+	for (const FAbilityBindInfo& AbilityBindInfo : Abilities)
+	{
+		HashPath(AbilityBindInfo.AbilityClass.ToSoftObjectPath());
+		HashPath(AbilityBindInfo.InputAction.ToSoftObjectPath());
+		Hash = FCrc::MemCrc32(&AbilityBindInfo.AbilityLevel, sizeof(AbilityBindInfo.AbilityLevel), Hash);
+		Hash = FCrc::MemCrc32(&AbilityBindInfo.InputBufferTime, sizeof(AbilityBindInfo.InputBufferTime), Hash);
+	}
+
+	for (const FEffectBindInfo& EffectBindInfo : Effects)
+	{
+		HashPath(FSoftObjectPath(EffectBindInfo.GameplayEffect.Get()));
+		Hash = FCrc::MemCrc32(&EffectBindInfo.EffectLevel, sizeof(EffectBindInfo.EffectLevel), Hash);
+	}
+
+	for (const FMappingContextBindInfo& MappingContextBindInfo : InputMappingContexts)
+	{
+		HashPath(MappingContextBindInfo.MappingContext.ToSoftObjectPath());
+		Hash = FCrc::MemCrc32(&MappingContextBindInfo.Priority, sizeof(MappingContextBindInfo.Priority), Hash);
+	}
+
+	// 0 marks a table that was never baked
+	return Hash != 0 ? Hash : 1;
+}
+
+void UTemplateGameplayAbilitySet::HandleObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	// Reinstancing is rare, rebuilding every set on the next grant is cheaper than finding the affected ones
+	for (TObjectIterator<UTemplateGameplayAbilitySet> It; It; ++It)
+	{
+		It->GrantData.Reset();
+	}
+}
+#endif
+
+const FTemplateAbilitySetGrantData::FAbilityEntry* UTemplateGameplayAbilitySet::FindAbilityEntry(const FGameplayAbilitySpec& Spec)
+{
+	// An ability granted twice by one set binds the first entry with an input action
+	const FTemplateAbilitySetGrantData::FAbilityEntry* FoundEntry = nullptr;
+	for (const FTemplateAbilitySetGrantData::FAbilityEntry& AbilityEntry : GetGrantData().Abilities)
+	{
+		if (AbilityEntry.AbilityCDO == Spec.Ability)
+		{
+			if (AbilityEntry.InputAction)
+			{
+				return &AbilityEntry;
+			}
+			FoundEntry = FoundEntry ? FoundEntry : &AbilityEntry;
+		}
+	}
+	return FoundEntry;
+}
+
+void UTemplateGameplayAbilitySet::BindAbility(AGameTemplateCharacter* PlayerCharacter,
+	const FTemplateAbilitySetGrantData::FAbilityEntry& AbilityEntry, FGameplayAbilitySpec& Spec) const
+{
+	check(Spec.Ability);
+	check(PlayerCharacter);
+
+	if (AbilityEntry.InputAction)
+	{
+		PlayerCharacter->SetInputBinding(AbilityEntry.InputAction, Spec, AbilityEntry.InputBufferTime);
 	}
 }
 
@@ -135,7 +418,7 @@ void UTemplateGameplayAbilitySet::UnbindAbility(AGameTemplateCharacter* PlayerCh
 	PlayerCharacter->ClearInputBinding(Spec);
 }
 
-void UTemplateGameplayAbilitySet::AddAbilitySpecHandles(const FGameplayAbilitySpecHandle& Handle)
+void FTemplateAbilitySetGrantedHandles::AddAbilitySpecHandles(const FGameplayAbilitySpecHandle& Handle)
 {
 	if (Handle.IsValid())
 	{
@@ -143,7 +426,7 @@ void UTemplateGameplayAbilitySet::AddAbilitySpecHandles(const FGameplayAbilitySp
 	}
 }
 
-void UTemplateGameplayAbilitySet::AddEffectSpecHandles(const FActiveGameplayEffectHandle& Handle)
+void FTemplateAbilitySetGrantedHandles::AddEffectSpecHandles(const FActiveGameplayEffectHandle& Handle)
 {
 	if (Handle.IsValid())
 	{
@@ -151,12 +434,25 @@ void UTemplateGameplayAbilitySet::AddEffectSpecHandles(const FActiveGameplayEffe
 	}
 }
 
-void UTemplateGameplayAbilitySet::AddAttributeSet(UAttributeSet* Set)
+void FTemplateAbilitySetGrantedHandles::AddAttributeSet(UAttributeSet* Set)
 {
 	GrantedAttributeSets.Add(Set);
 }
 
-void UTemplateGameplayAbilitySet::AddAbilitiesSpec(const FGameplayAbilitySpec& Spec)
+void FTemplateAbilitySetGrantedHandles::AddAbilitiesSpec(const FGameplayAbilitySpec& Spec)
 {
 	AbilitiesSpec.Add(Spec);
 }
+
+void FTemplateAbilitySetGrantedHandles::Reset()
+{
+	AbilitySpecHandles.Reset();
+	EffectSpecHandles.Reset();
+	AbilitiesSpec.Reset();
+	GrantedAttributeSets.Reset();
+}
+
+SIZE_T FTemplateAbilitySetGrantedHandles::GetAllocatedSize() const
+{
+	return AbilitySpecHandles.GetAllocatedSize() + EffectSpecHandles.GetAllocatedSize() + AbilitiesSpec.GetAllocatedSize() + GrantedAttributeSets.GetAllocatedSize();
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateGameplayTagBits.h"
+
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+
+namespace TemplateGameplayTagBitsImpl
+{
+	uint32 TagTreeGeneration = 0;
+
+	static void HandleTagTreeChanged()
+	{
+		++TagTreeGeneration;
+	}
+}
+
+FTemplateGameplayTagBits FTemplateGameplayTagBits::MakeQuery(const FGameplayTagContainer& Tags)
+{
+	FTemplateGameplayTagBits Query;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		Query.SetTag(Tag, true);
+	}
+	return Query;
+}
+
+void FTemplateGameplayTagBits::SetTag(const FGameplayTag& Tag, bool bValue)
+{
+	const int32 BitIndex = GetBitIndex(Tag);
+	if (BitIndex == INDEX_NONE)
+	{
+		// A cleared tag without an index was never set, a set one can't be answered for
+		bComplete &= !bValue;
+		return;
+	}
+
+	const int32 WordIndex = BitIndex / 64;
+	const uint64 Mask = uint64(1) << (BitIndex % 64);
+
+	if (bValue)
+	{
+		if (WordIndex >= Words.Num())
+		{
+			Words.SetNumZeroed(WordIndex + 1);
+		}
+		Words[WordIndex] |= Mask;
+	}
+	else if (WordIndex < Words.Num())
+	{
+		Words[WordIndex] &= ~Mask;
+	}
+}
+
+void FTemplateGameplayTagBits::AddTagAndParents(const FGameplayTag& Tag)
+{
+	for (const FGameplayTag& ParentTag : Tag.GetGameplayTagParents())
+	{
+		SetTag(ParentTag, true);
+	}
+}
+
+void FTemplateGameplayTagBits::Reset()
+{
+	Words.Reset();
+	TagTreeGeneration = GetTagTreeGeneration();
+	bComplete = true;
+}
+
+bool FTemplateGameplayTagBits::IsStale() const
+{
+	return TagTreeGeneration != GetTagTreeGeneration();
+}
+
+bool FTemplateGameplayTagBits::HasTag(const FGameplayTag& Tag) const
+{
+	const int32 BitIndex = GetBitIndex(Tag);
+	return BitIndex != INDEX_NONE && (GetWord(BitIndex / 64) & (uint64(1) << (BitIndex % 64))) != 0;
+}
+
+bool FTemplateGameplayTagBits::HasAll(const FTemplateGameplayTagBits& Query) const
+{
+	for (int32 WordIndex = 0; WordIndex < Query.Words.Num(); ++WordIndex)
+	{
+		if ((Query.Words[WordIndex] & ~GetWord(WordIndex)) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FTemplateGameplayTagBits::HasAny(const FTemplateGameplayTagBits& Query) const
+{
+	const int32 NumWords = FMath::Min(Words.Num(), Query.Words.Num());
+	for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+	{
+		if ((Query.Words[WordIndex] & Words[WordIndex]) != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 FTemplateGameplayTagBits::GetBitIndex(const FGameplayTag& Tag)
+{
+	if (!Tag.IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	const FGameplayTagNetIndex NetIndex = UGameplayTagsManager::Get().GetNetIndexFromTag(Tag);
+	return NetIndex != INVALID_TAGNETINDEX ? static_cast<int32>(NetIndex) : INDEX_NONE;
+}
+
+uint32 FTemplateGameplayTagBits::GetTagTreeGeneration()
+{
+	// Registered on first use, before any bits exist
+	static const FDelegateHandle TagTreeChangedHandle = IGameplayTagsModule::OnGameplayTagTreeChanged.AddStatic(&TemplateGameplayTagBitsImpl::HandleTagTreeChanged);
+	return TemplateGameplayTagBitsImpl::TagTreeGeneration;
+}
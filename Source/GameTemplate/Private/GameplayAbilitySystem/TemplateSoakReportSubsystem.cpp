@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayAbilitySystem/TemplateSoakReportSubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameTemplate.h"
+
+static TAutoConsoleVariable<float> CVarSoakReportInterval(
+	TEXT("Template.Soak.ReportInterval"),
+	0.0f,
+	TEXT("Seconds between soak reports in the log. 0 disables reporting"));
+
+bool UTemplateSoakReportSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	return Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+void UTemplateSoakReportSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float ReportInterval = CVarSoakReportInterval.GetValueOnGameThread();
+	if (ReportInterval <= 0.0f || !GetWorld()->IsGameWorld())
+	{
+		return;
+	}
+
+	// Game thread time of the previous frame, the same value stat unit shows
+	const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	GameThreadMsSum += GameThreadMs;
+	GameThreadMsMax = FMath::Max(GameThreadMsMax, GameThreadMs);
+	++NumFrames;
+
+	const double Now = FPlatformTime::Seconds();
+	if (NextReportTime == 0.0)
+	{
+		NextReportTime = Now + ReportInterval;
+	}
+	else if (Now >= NextReportTime)
+	{
+		Report();
+		NextReportTime = Now + ReportInterval;
+	}
+}
+
+TStatId UTemplateSoakReportSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTemplateSoakReportSubsystem, STATGROUP_Tickables);
+}
+
+void UTemplateSoakReportSubsystem::Report()
+{
+	const FTemplateAbilityNetCounters& Counters = NetCounters;
+
+	UE_LOG(ProjectLog, Display, TEXT("Soak: Frames=%d GameThreadAvg=%.2fms GameThreadMax=%.2fms ActivationRequests=%d ActivationFailures=%d PredictionRejections=%d"),
+		NumFrames, NumFrames > 0 ? GameThreadMsSum / NumFrames : 0.0, GameThreadMsMax,
+		Counters.ServerActivationRequests, Counters.ServerActivationFailures, Counters.PredictionRejections);
+	UE_LOG(ProjectLog, Display, TEXT("Soak: BatchedRPCs=%d UnbatchedActivationRPCs=%d UnbatchedEndAbilityRPCs=%d"),
+		Counters.BatchedRPCs, Counters.UnbatchedActivationRPCs, Counters.UnbatchedEndAbilityRPCs);
+
+	// Client connections on the server, the server connection on clients (non const, the remote address getter is)
+	if (UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		TArray<UNetConnection*> Connections(NetDriver->ClientConnections);
+		if (NetDriver->ServerConnection)
+		{
+			Connections.Add(NetDriver->ServerConnection);
+		}
+
+		for (UNetConnection* Connection : Connections)
+		{
+			UE_LOG(ProjectLog, Display, TEXT("Soak: Connection=%s OutBytesPerSecond=%d InBytesPerSecond=%d OutPacketsLost=%d InPacketsLost=%d AvgLag=%.0fms"),
+				*Connection->LowLevelGetRemoteAddress(true), Connection->OutBytesPerSecond, Connection->InBytesPerSecond,
+				Connection->OutPacketsLost, Connection->InPacketsLost, Connection->AvgLag * 1000.0);
+		}
+	}
+
+	NetCounters = FTemplateAbilityNetCounters();
+	NumFrames = 0;
+	GameThreadMsSum = 0.0;
+	GameThreadMsMax = 0.0;
+}
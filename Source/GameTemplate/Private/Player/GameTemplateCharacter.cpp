@@ -7,7 +7,30 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "GameplayEffectAggregator.h"
 #include "EnhancedInputSubsystems.h"
+#include "InputMappingContext.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "GameplayAbilitySystem/Attributes/TemplateAttributeSet.h"
+#include "GameplayAbilitySystem/TemplateAbilityGrantSubsystem.h"
+#include "GameplayAbilitySystem/TemplateAbilityMemoryReport.h"
+#include "GameplayAbilitySystem/TemplateAttributeSnapshotSubsystem.h"
+#include "GameTemplate.h"
+#include "Player/TemplateInputReplaySubsystem.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Significance"), STAT_TemplateCharacter_UpdateSignificance, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throttled Ability Systems"), STAT_TemplateCharacter_ThrottledAbilitySystems, STATGROUP_TemplateAbilitySystem);
+DECLARE_CYCLE_STAT(TEXT("Flush Mapping Contexts"), STAT_TemplateCharacter_FlushMappingContexts, STATGROUP_TemplateAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Control Mappings Rebuilds"), STAT_TemplateCharacter_ControlMappingsRebuilds, STATGROUP_TemplateAbilitySystem);
+DECLARE_CYCLE_STAT(TEXT("Save Ability Checkpoint"), STAT_TemplateCharacter_SaveAbilityCheckpoint, STATGROUP_TemplateAbilitySystem);
+DECLARE_CYCLE_STAT(TEXT("Restore Ability Checkpoint"), STAT_TemplateCharacter_RestoreAbilityCheckpoint, STATGROUP_TemplateAbilitySystem);
+
+static TAutoConsoleVariable<bool> CVarSignificanceThrottling(
+	TEXT("Template.Significance.Enable"),
+	true,
+	TEXT("When disabled every pawn uses the first significance bucket, to compare against throttled update costs"));
 
 namespace AbilityInputBindingImpl
 {
@@ -18,6 +41,17 @@ namespace AbilityInputBindingImpl
 	{
 		return ++IncrementingInputID;
 	}
+
+	/** Specs start with INDEX_NONE, cleared bindings reset them to InvalidInputID **/
+	static bool HasInputID(int32 InputID)
+	{
+		return InputID != InvalidInputID && InputID != INDEX_NONE;
+	}
+
+	static bool HasInputID(const FGameplayAbilitySpec& Spec)
+	{
+		return HasInputID(Spec.InputID);
+	}
 }
 
 
@@ -46,16 +80,26 @@ AGameTemplateCharacter::AGameTemplateCharacter()
 	GetCharacterMovement()->MinAnalogWalkSpeed = 20.f;
 	GetCharacterMovement()->BrakingDecelerationWalking = 2000.f;
 
+	// Note: The camera subobjects are optional, so Blueprint data tolerates them missing. The server target never
+	// creates them, other binaries running as a dedicated server destroy them in PostInitializeComponents
+#if !UE_SERVER
 	// Create a camera boom (pulls in towards the player if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-	CameraBoom->SetupAttachment(RootComponent);
-	CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
-	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	CameraBoom = CreateOptionalDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
+	if (CameraBoom)
+	{
+		CameraBoom->SetupAttachment(RootComponent);
+		CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
+		CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	}
 
 	// Create a follow camera
-	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
-	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+	FollowCamera = CreateOptionalDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
+	if (FollowCamera)
+	{
+		FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
+		FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+	}
+#endif // !UE_SERVER
 
 	// Initialize AbilitySystemComponent, and set it to be explicitly replicated
 	AbilitySystemComponent = CreateDefaultSubobject<UTemplateAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
@@ -68,6 +112,23 @@ AGameTemplateCharacter::AGameTemplateCharacter()
 }
 
 void AGameTemplateCharacter::GiveAbilities()
+{
+	if (HasAuthority() && AbilitySystemComponent)
+	{
+		// Spread grants over several frames when many pawns spawn together
+		UTemplateAbilityGrantSubsystem* GrantSubsystem = GetWorld()->GetSubsystem<UTemplateAbilityGrantSubsystem>();
+		if (GrantSubsystem && UTemplateAbilityGrantSubsystem::IsTimeSliced())
+		{
+			GrantSubsystem->QueueGrant(this);
+		}
+		else
+		{
+			CommitAbilitySets();
+		}
+	}
+}
+
+void AGameTemplateCharacter::CommitAbilitySets()
 {
 	if (HasAuthority() && AbilitySystemComponent)
 	{
@@ -75,9 +136,16 @@ void AGameTemplateCharacter::GiveAbilities()
 		{
 			if (AbilitySet)
 			{
-				AbilitySet->GiveAbilities(AbilitySystemComponent, this);
+				AbilitySet->GiveAbilities(AbilitySystemComponent, this, GrantedAbilitySets.FindOrAdd(AbilitySet));
+				QueueMappingContextChanges(AbilitySet, true);
 			}
 		}
+
+		// Mirror tracked attributes for crowd-wide queries
+		if (UTemplateAttributeSnapshotSubsystem* SnapshotSubsystem = GetWorld()->GetSubsystem<UTemplateAttributeSnapshotSubsystem>())
+		{
+			SnapshotSubsystem->RegisterAbilitySystem(AbilitySystemComponent);
+		}
 	}
 }
 
@@ -86,16 +154,421 @@ void AGameTemplateCharacter::RemoveAbilities()
 	// Remove any abilities added from previous call
 	if (HasAuthority() && AbilitySystemComponent)
 	{
-		for (UTemplateGameplayAbilitySet* AbilitySet : AbilitySets)
+		if (UTemplateAbilityGrantSubsystem* GrantSubsystem = GetWorld()->GetSubsystem<UTemplateAbilityGrantSubsystem>())
 		{
-			if (AbilitySet)
+			GrantSubsystem->CancelGrant(this);
+		}
+
+		if (UTemplateAttributeSnapshotSubsystem* SnapshotSubsystem = GetWorld()->GetSubsystem<UTemplateAttributeSnapshotSubsystem>())
+		{
+			SnapshotSubsystem->UnregisterAbilitySystem(AbilitySystemComponent);
+		}
+
+		for (auto& GrantedAbilitySet : GrantedAbilitySets)
+		{
+			if (GrantedAbilitySet.Key)
 			{
-				AbilitySet->RemoveAbilities(AbilitySystemComponent,this);
+				GrantedAbilitySet.Key->RemoveAbilities(AbilitySystemComponent, this, GrantedAbilitySet.Value);
+				QueueMappingContextChanges(GrantedAbilitySet.Key, false);
 			}
 		}
+		GrantedAbilitySets.Reset();
+	}
+}
+
+void AGameTemplateCharacter::SaveAbilityCheckpoint(FTemplateAbilityCheckpoint& OutCheckpoint) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateCharacter_SaveAbilityCheckpoint);
+
+	OutCheckpoint = FTemplateAbilityCheckpoint();
+	if (!AbilitySystemComponent)
+	{
+		return;
+	}
+
+	// Effects granted by a set are restored into that set's handles, so removing the set still removes them
+	TMap<FActiveGameplayEffectHandle, int32> EffectAbilitySetIndices;
+
+	OutCheckpoint.AbilitySets.Reserve(GrantedAbilitySets.Num());
+	for (const auto& GrantedAbilitySet : GrantedAbilitySets)
+	{
+		if (!GrantedAbilitySet.Key)
+		{
+			continue;
+		}
+
+		const int32 AbilitySetIndex = OutCheckpoint.AbilitySets.Num();
+		FTemplateAbilityCheckpoint::FAbilitySetState& AbilitySetState = OutCheckpoint.AbilitySets.AddDefaulted_GetRef();
+		AbilitySetState.AbilitySetPath = GrantedAbilitySet.Key->GetPathName();
+
+		AbilitySetState.Abilities.Reserve(GrantedAbilitySet.Value.AbilitySpecHandles.Num());
+		for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : GrantedAbilitySet.Value.AbilitySpecHandles)
+		{
+			FTemplateAbilityCheckpoint::FAbilityState& AbilityState = AbilitySetState.Abilities.AddDefaulted_GetRef();
+			if (const FGameplayAbilitySpec* AbilitySpec = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilitySpecHandle))
+			{
+				AbilityState.Level = AbilitySpec->Level;
+				AbilityState.InputID = AbilitySpec->InputID;
+			}
+		}
+
+		for (const FActiveGameplayEffectHandle& EffectSpecHandle : GrantedAbilitySet.Value.EffectSpecHandles)
+		{
+			EffectAbilitySetIndices.Add(EffectSpecHandle, AbilitySetIndex);
+		}
+	}
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	for (FActiveGameplayEffectsContainer::ConstIterator It = AbilitySystemComponent->GetActiveGameplayEffects().CreateConstIterator(); It; ++It)
+	{
+		const FActiveGameplayEffect& ActiveEffect = *It;
+		if (ActiveEffect.IsPendingRemove || !ActiveEffect.Spec.Def)
+		{
+			continue;
+		}
+
+		FTemplateAbilityCheckpoint::FEffectState& EffectState = OutCheckpoint.Effects.AddDefaulted_GetRef();
+		EffectState.EffectClassPath = ActiveEffect.Spec.Def->GetClass()->GetPathName();
+		EffectState.Level = ActiveEffect.Spec.GetLevel();
+		EffectState.StackCount = ActiveEffect.Spec.StackCount;
+		EffectState.RemainingDuration = ActiveEffect.GetTimeRemaining(WorldTime);
+		if (const int32* AbilitySetIndex = EffectAbilitySetIndices.Find(ActiveEffect.Handle))
+		{
+			EffectState.AbilitySetIndex = *AbilitySetIndex;
+		}
+	}
+
+	for (UAttributeSet* AttributeSet : AbilitySystemComponent->GetSpawnedAttributes())
+	{
+		if (UTemplateAttributeSet* TemplateAttributeSet = Cast<UTemplateAttributeSet>(AttributeSet))
+		{
+			FTemplateAbilityCheckpoint::FAttributeSetState& AttributeSetState = OutCheckpoint.AttributeSets.AddDefaulted_GetRef();
+			AttributeSetState.AttributeSetClassPath = TemplateAttributeSet->GetClass()->GetPathName();
+
+			FMemoryWriter Writer(AttributeSetState.Values);
+			TemplateAttributeSet->SerializeCheckpoint(Writer);
+		}
 	}
 }
 
+bool AGameTemplateCharacter::RestoreAbilityCheckpoint(const FTemplateAbilityCheckpoint& Checkpoint)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateCharacter_RestoreAbilityCheckpoint);
+
+	if (!HasAuthority() || !AbilitySystemComponent)
+	{
+		return false;
+	}
+
+	// A queued grant would give the sets again after the restore
+	if (UTemplateAbilityGrantSubsystem* GrantSubsystem = GetWorld()->GetSubsystem<UTemplateAbilityGrantSubsystem>())
+	{
+		GrantSubsystem->CancelGrant(this);
+	}
+
+	// Attributes are aggregated once, after every set, effect and base value is back
+	FScopedAggregatorOnDirtyBatch AggregatorBatch;
+
+	// Sets are normally loaded already, only load the ones that aren't
+	TArray<UTemplateGameplayAbilitySet*, TInlineAllocator<8>> RestoredAbilitySets;
+	TBitArray<TInlineAllocator<1>> InPlaceAbilitySets;
+	for (const FTemplateAbilityCheckpoint::FAbilitySetState& AbilitySetState : Checkpoint.AbilitySets)
+	{
+		UTemplateGameplayAbilitySet* AbilitySet = FindObject<UTemplateGameplayAbilitySet>(nullptr, *AbilitySetState.AbilitySetPath);
+		if (!AbilitySet)
+		{
+			AbilitySet = LoadObject<UTemplateGameplayAbilitySet>(nullptr, *AbilitySetState.AbilitySetPath);
+		}
+		if (!AbilitySet)
+		{
+			UE_LOG(ProjectLog, Warning, TEXT("Ability set [%s] of the checkpoint could not be loaded"), *AbilitySetState.AbilitySetPath);
+		}
+
+		// A set still granted with the same abilities keeps its specs, attribute sets and input bindings
+		const FTemplateAbilitySetGrantedHandles* GrantedHandles = AbilitySet ? GrantedAbilitySets.Find(AbilitySet) : nullptr;
+		InPlaceAbilitySets.Add(GrantedHandles && !RestoredAbilitySets.Contains(AbilitySet) && GrantedHandles->AbilitySpecHandles.Num() == AbilitySetState.Abilities.Num());
+		RestoredAbilitySets.Add(AbilitySet);
+	}
+
+	// Take away the sets the checkpoint doesn't keep in place
+	for (auto It = GrantedAbilitySets.CreateIterator(); It; ++It)
+	{
+		const int32 AbilitySetIndex = RestoredAbilitySets.Find(It->Key);
+		if (AbilitySetIndex == INDEX_NONE || !InPlaceAbilitySets[AbilitySetIndex])
+		{
+			if (It->Key)
+			{
+				It->Key->RemoveAbilities(AbilitySystemComponent, this, It->Value);
+				QueueMappingContextChanges(It->Key, false);
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	// Checkpointed InputIDs may come from another process and collide with IDs handed out here,
+	// give each one a fresh ID and keep only which abilities share one
+	TMap<int32, int32, TInlineSetAllocator<8>> RemappedInputIDs;
+	TArray<FTemplateAbilityCheckpoint::FAbilityState, TInlineAllocator<16>> AbilityStates;
+
+	for (int32 AbilitySetIndex = 0; AbilitySetIndex < RestoredAbilitySets.Num(); ++AbilitySetIndex)
+	{
+		UTemplateGameplayAbilitySet* AbilitySet = RestoredAbilitySets[AbilitySetIndex];
+		const FTemplateAbilityCheckpoint::FAbilitySetState& AbilitySetState = Checkpoint.AbilitySets[AbilitySetIndex];
+		if (!AbilitySet)
+		{
+			continue;
+		}
+
+		// Only levels can differ in place, the live InputIDs already belong to this process
+		if (InPlaceAbilitySets[AbilitySetIndex])
+		{
+			const FTemplateAbilitySetGrantedHandles& GrantedHandles = GrantedAbilitySets.FindChecked(AbilitySet);
+			for (int32 Index = 0; Index < GrantedHandles.AbilitySpecHandles.Num(); ++Index)
+			{
+				FGameplayAbilitySpec* AbilitySpec = AbilitySystemComponent->FindAbilitySpecFromHandle(GrantedHandles.AbilitySpecHandles[Index]);
+				if (AbilitySpec && AbilitySpec->Level != AbilitySetState.Abilities[Index].Level)
+				{
+					AbilitySpec->Level = AbilitySetState.Abilities[Index].Level;
+					AbilitySystemComponent->MarkAbilitySpecDirty(*AbilitySpec);
+				}
+			}
+			continue;
+		}
+
+		AbilityStates = AbilitySetState.Abilities;
+		for (FTemplateAbilityCheckpoint::FAbilityState& AbilityState : AbilityStates)
+		{
+			using namespace AbilityInputBindingImpl;
+
+			if (HasInputID(AbilityState.InputID))
+			{
+				int32* RemappedInputID = RemappedInputIDs.Find(AbilityState.InputID);
+				AbilityState.InputID = RemappedInputID ? *RemappedInputID : RemappedInputIDs.Add(AbilityState.InputID, GetNextInputID());
+			}
+		}
+
+		// Grant the set with its checkpointed levels and InputIDs, its effects come from the checkpoint below
+		AbilitySet->RestoreAbilities(AbilitySystemComponent, this, AbilityStates, GrantedAbilitySets.FindOrAdd(AbilitySet));
+		QueueMappingContextChanges(AbilitySet, true);
+	}
+
+	// Infinite effects of sets kept in place stay applied when the checkpoint holds them unchanged
+	TArray<UClass*, TInlineAllocator<16>> EffectClasses;
+	TBitArray<TInlineAllocator<1>> KeptEffects(false, Checkpoint.Effects.Num());
+	TSet<FActiveGameplayEffectHandle> KeptEffectHandles;
+	for (int32 EffectIndex = 0; EffectIndex < Checkpoint.Effects.Num(); ++EffectIndex)
+	{
+		const FTemplateAbilityCheckpoint::FEffectState& EffectState = Checkpoint.Effects[EffectIndex];
+
+		UClass* EffectClass = FindObject<UClass>(nullptr, *EffectState.EffectClassPath);
+		if (!EffectClass)
+		{
+			EffectClass = StaticLoadClass(UGameplayEffect::StaticClass(), nullptr, *EffectState.EffectClassPath);
+		}
+		EffectClasses.Add(EffectClass);
+
+		if (!EffectClass || EffectState.RemainingDuration >= 0.0f || !InPlaceAbilitySets.IsValidIndex(EffectState.AbilitySetIndex) || !InPlaceAbilitySets[EffectState.AbilitySetIndex])
+		{
+			continue;
+		}
+
+		for (const FActiveGameplayEffectHandle& EffectHandle : GrantedAbilitySets.FindChecked(RestoredAbilitySets[EffectState.AbilitySetIndex]).EffectSpecHandles)
+		{
+			const FActiveGameplayEffect* ActiveEffect = AbilitySystemComponent->GetActiveGameplayEffect(EffectHandle);
+			if (ActiveEffect && !ActiveEffect->IsPendingRemove && ActiveEffect->Spec.Def && ActiveEffect->Spec.Def->GetClass() == EffectClass
+				&& ActiveEffect->Spec.GetLevel() == EffectState.Level && ActiveEffect->Spec.StackCount == EffectState.StackCount
+				&& ActiveEffect->GetDuration() == FGameplayEffectConstants::INFINITE_DURATION && !KeptEffectHandles.Contains(EffectHandle))
+			{
+				KeptEffectHandles.Add(EffectHandle);
+				KeptEffects[EffectIndex] = true;
+				break;
+			}
+		}
+	}
+
+	// The checkpoint holds every active effect, not only the ones the sets granted. Drop the rest so nothing is applied twice
+	TArray<FActiveGameplayEffectHandle, TInlineAllocator<16>> RemovedEffectHandles;
+	for (FActiveGameplayEffectsContainer::ConstIterator It = AbilitySystemComponent->GetActiveGameplayEffects().CreateConstIterator(); It; ++It)
+	{
+		if (!KeptEffectHandles.Contains(It->Handle))
+		{
+			RemovedEffectHandles.Add(It->Handle);
+		}
+	}
+	for (const FActiveGameplayEffectHandle& EffectHandle : RemovedEffectHandles)
+	{
+		AbilitySystemComponent->RemoveActiveGameplayEffect(EffectHandle);
+	}
+
+	for (auto& GrantedAbilitySet : GrantedAbilitySets)
+	{
+		GrantedAbilitySet.Value.EffectSpecHandles.RemoveAll([&KeptEffectHandles](const FActiveGameplayEffectHandle& EffectHandle) { return !KeptEffectHandles.Contains(EffectHandle); });
+	}
+
+	// Base values first, the restored effects modify on top of them
+	bool bRestoredAttributes = true;
+	TArray<UAttributeSet*, TInlineAllocator<8>> RestoredAttributeSets;
+	for (const FTemplateAbilityCheckpoint::FAttributeSetState& AttributeSetState : Checkpoint.AttributeSets)
+	{
+		UTemplateAttributeSet* TemplateAttributeSet = nullptr;
+		for (UAttributeSet* AttributeSet : AbilitySystemComponent->GetSpawnedAttributes())
+		{
+			// Two sets may grant the same attribute set class, match them in order
+			if (AttributeSet && !RestoredAttributeSets.Contains(AttributeSet) && AttributeSet->GetClass()->GetPathName() == AttributeSetState.AttributeSetClassPath)
+			{
+				TemplateAttributeSet = Cast<UTemplateAttributeSet>(AttributeSet);
+				RestoredAttributeSets.Add(AttributeSet);
+				break;
+			}
+		}
+
+		FMemoryReader Reader(AttributeSetState.Values);
+		if (TemplateAttributeSet)
+		{
+			TemplateAttributeSet->SerializeCheckpoint(Reader);
+		}
+		bRestoredAttributes &= TemplateAttributeSet && !Reader.IsError();
+	}
+
+	// Apply the other effects with the time they had left, from the set's prototype when it matches
+	TArray<FGameplayEffectSpecHandle> EffectSpecs;
+	TArray<int32> EffectAbilitySetIndices;
+	EffectSpecs.Reserve(Checkpoint.Effects.Num());
+	EffectAbilitySetIndices.Reserve(Checkpoint.Effects.Num());
+
+	for (int32 EffectIndex = 0; EffectIndex < Checkpoint.Effects.Num(); ++EffectIndex)
+	{
+		const FTemplateAbilityCheckpoint::FEffectState& EffectState = Checkpoint.Effects[EffectIndex];
+		UClass* EffectClass = EffectClasses[EffectIndex];
+		if (KeptEffects[EffectIndex])
+		{
+			continue;
+		}
+		if (!EffectClass)
+		{
+			UE_LOG(ProjectLog, Warning, TEXT("Gameplay effect [%s] of the checkpoint could not be loaded"), *EffectState.EffectClassPath);
+			continue;
+		}
+
+		const FGameplayEffectSpec* Prototype = nullptr;
+		if (RestoredAbilitySets.IsValidIndex(EffectState.AbilitySetIndex) && RestoredAbilitySets[EffectState.AbilitySetIndex])
+		{
+			for (const FTemplateAbilitySetGrantData::FEffectEntry& EffectEntry : RestoredAbilitySets[EffectState.AbilitySetIndex]->GetGrantData().Effects)
+			{
+				if (EffectEntry.Prototype.IsValid() && EffectEntry.EffectClass == EffectClass && EffectEntry.EffectLevel == EffectState.Level)
+				{
+					Prototype = EffectEntry.Prototype.Get();
+					break;
+				}
+			}
+		}
+
+		FGameplayEffectSpecHandle EffectSpec = Prototype
+			? AbilitySystemComponent->MakeOutgoingSpecFromPrototype(*Prototype)
+			: AbilitySystemComponent->MakeOutgoingSpec(EffectClass, EffectState.Level, AbilitySystemComponent->MakeEffectContext());
+		EffectSpec.Data->SetStackCount(EffectState.StackCount);
+		if (EffectState.RemainingDuration >= 0.0f)
+		{
+			EffectSpec.Data->SetDuration(EffectState.RemainingDuration, true);
+		}
+
+		EffectSpecs.Add(EffectSpec);
+		EffectAbilitySetIndices.Add(EffectState.AbilitySetIndex);
+	}
+
+	TArray<FActiveGameplayEffectHandle> EffectHandles;
+	AbilitySystemComponent->ApplyGameplayEffectSpecsToSelf(EffectSpecs, EffectHandles);
+
+	for (int32 Index = 0; Index < EffectHandles.Num(); ++Index)
+	{
+		const int32 AbilitySetIndex = EffectAbilitySetIndices[Index];
+		if (RestoredAbilitySets.IsValidIndex(AbilitySetIndex) && RestoredAbilitySets[AbilitySetIndex])
+		{
+			GrantedAbilitySets.FindChecked(RestoredAbilitySets[AbilitySetIndex]).AddEffectSpecHandles(EffectHandles[Index]);
+		}
+	}
+
+	if (UTemplateAttributeSnapshotSubsystem* SnapshotSubsystem = GetWorld()->GetSubsystem<UTemplateAttributeSnapshotSubsystem>())
+	{
+		SnapshotSubsystem->RegisterAbilitySystem(AbilitySystemComponent);
+	}
+
+	return bRestoredAttributes;
+}
+
+void AGameTemplateCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// A dedicated server never renders, drop the camera components before they tick (only reached by non-server binaries run with -server)
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		if (FollowCamera)
+		{
+			FollowCamera->DestroyComponent();
+			FollowCamera = nullptr;
+		}
+		if (CameraBoom)
+		{
+			CameraBoom->DestroyComponent();
+			CameraBoom = nullptr;
+		}
+	}
+
+	// Remote clients bind ability input from replicated specs, so their presses reach the ability system and batch their RPCs
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->OnAbilitySpecGiven.AddUObject(this, &AGameTemplateCharacter::HandleAbilitySpecGiven);
+		AbilitySystemComponent->OnAbilitySpecRemoved.AddUObject(this, &AGameTemplateCharacter::HandleAbilitySpecRemoved);
+	}
+}
+
+void AGameTemplateCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (SignificanceBuckets.Num() > 0)
+	{
+		// Spread updates across frames so pawns spawned together don't update together
+		const float FirstDelay = FMath::FRandRange(0.0f, SignificanceUpdateInterval);
+		GetWorldTimerManager().SetTimer(SignificanceTimerHandle, this, &AGameTemplateCharacter::UpdateSignificance, SignificanceUpdateInterval, true, FirstDelay);
+	}
+}
+
+void AGameTemplateCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(SignificanceTimerHandle);
+
+	RemoveClientMappingContexts();
+
+	// The flush timer won't fire for a destroyed character, apply pending changes now
+	if (PendingMappingContextChanges.Num() > 0)
+	{
+		FlushMappingContextChanges();
+	}
+	SetMappingContextSubsystem(nullptr);
+
+	// Drop buffered presses so their listeners are unbound
+	for (auto& InputBinding : MappedAbilities)
+	{
+		InputBinding.Value.BufferedPressExpireTime = 0.0;
+	}
+	UpdateBufferedInputListeners();
+
+	if (SignificanceBucketIndex > 0)
+	{
+		DEC_DWORD_STAT(STAT_TemplateCharacter_ThrottledAbilitySystems);
+	}
+	SignificanceBucketIndex = INDEX_NONE;
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->ResetSignificanceBucket();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AGameTemplateCharacter::PossessedBy(AController* NewController)
 {
 	Super::PossessedBy(NewController);
@@ -106,6 +579,17 @@ void AGameTemplateCharacter::PossessedBy(AController* NewController)
 	GiveAbilities();
 }
 
+void AGameTemplateCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	// RemoveAbilities doesn't run on clients, take the contexts back when the local player stops controlling this pawn
+	if (!IsLocallyControlled())
+	{
+		RemoveClientMappingContexts();
+	}
+}
+
 void AGameTemplateCharacter::UnPossessed()
 {
 	Super::UnPossessed();
@@ -123,37 +607,29 @@ void AGameTemplateCharacter::Destroyed()
 //////////////////////////////////////////////////////////////////////////
 // Ability Input handling
 
-void AGameTemplateCharacter::SetInputBinding(UInputAction* InputAction, FGameplayAbilitySpec& AbilitySpec)
+void AGameTemplateCharacter::SetInputBinding(UInputAction* InputAction, FGameplayAbilitySpec& AbilitySpec, float InputBufferTime)
 {
 	using namespace AbilityInputBindingImpl;
 
-	if (AbilitySpec.InputID == InvalidInputID)
-	{
-		AbilitySpec.InputID = GetNextInputID();
-	}
-
 	FAbilityInputBinding* AbilityInputBinding = MappedAbilities.Find(InputAction);
 	if (!AbilityInputBinding)
 	{
 		AbilityInputBinding = &MappedAbilities.Add(InputAction);
-	}
 
-	AbilityInputBinding->BoundAbilitiesStack.AddUnique(AbilitySpec.Handle);
+		// A spec restored from a checkpoint or replicated from the server brings the InputID its binding has there
+		AbilityInputBinding->InputID = HasInputID(AbilitySpec) ? AbilitySpec.InputID : GetNextInputID();
+	}
 
-	if (EnhancedInputComponent)
+	// Every ability bound to an action shares its InputID, it stays the same across input component changes
+	if (!HasInputID(AbilitySpec))
 	{
-		// Pressed event
-		if (AbilityInputBinding->OnPressedHandle == 0)
-		{
-			AbilityInputBinding->OnPressedHandle = EnhancedInputComponent->BindAction(InputAction, ETriggerEvent::Triggered, this, &AGameTemplateCharacter::OnAbilityInputPressed, InputAction).GetHandle();
-		}
-
-		// Released event
-		if (AbilityInputBinding->OnReleasedHandle == 0)
-		{
-			AbilityInputBinding->OnReleasedHandle = EnhancedInputComponent->BindAction(InputAction, ETriggerEvent::Completed, this, &AGameTemplateCharacter::OnAbilityInputReleased, InputAction).GetHandle();
-		}
+		AbilitySpec.InputID = AbilityInputBinding->InputID;
 	}
+
+	AbilityInputBinding->BoundAbilitiesStack.AddUnique(AbilitySpec.Handle);
+	AbilityInputBinding->InputBufferTime = FMath::Max(AbilityInputBinding->InputBufferTime, InputBufferTime);
+
+	BindAbilityInput(InputAction, *AbilityInputBinding);
 }
 
 void AGameTemplateCharacter::ClearInputBinding(FGameplayAbilitySpec& AbilitySpec)
@@ -163,7 +639,7 @@ void AGameTemplateCharacter::ClearInputBinding(FGameplayAbilitySpec& AbilitySpec
 	TArray<UInputAction*> InputActionsToClear;
 	for (auto& InputBinding : MappedAbilities)
 	{
-		if (InputBinding.Value.BoundAbilitiesStack.Find(AbilitySpec.Handle))
+		if (InputBinding.Value.BoundAbilitiesStack.Contains(AbilitySpec.Handle))
 		{
 			InputActionsToClear.Add(InputBinding.Key);
 		}
@@ -195,6 +671,8 @@ UAbilitySystemComponent* AGameTemplateCharacter::GetAbilitySystemComponent() con
 
 void AGameTemplateCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
 {
+	// There are no local players on a dedicated server
+#if !UE_SERVER
 	// Add input mapping context
 	if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
 	{
@@ -203,13 +681,27 @@ void AGameTemplateCharacter::SetupPlayerInputComponent(class UInputComponent* Pl
 			Subsystem->AddMappingContext(DefaultMappingContext, InputPriority);
 		}
 	}
+
+	// Abilities are granted by the server, a remote client adds the mapping contexts of its sets itself (once, the input component is recreated on every restart)
+	if (!HasAuthority() && !bAddedClientMappingContexts)
+	{
+		bAddedClientMappingContexts = true;
+		for (UTemplateGameplayAbilitySet* AbilitySet : AbilitySets)
+		{
+			QueueMappingContextChanges(AbilitySet, true);
+		}
+	}
 	
-	// Set up action bindings
-	if ((EnhancedInputComponent = CastChecked<UEnhancedInputComponent>(PlayerInputComponent)))
+	UEnhancedInputComponent* NewInputComponent = CastChecked<UEnhancedInputComponent>(PlayerInputComponent);
+	const bool bNewInputComponent = NewInputComponent != EnhancedInputComponent;
+	EnhancedInputComponent = NewInputComponent;
+
+	// Set up action bindings, once per input component
+	if (bNewInputComponent)
 	{
 		// Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &ACharacter::Jump);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &AGameTemplateCharacter::OnJumpInputPressed);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &AGameTemplateCharacter::OnJumpInputReleased);
 
 		// Moving
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AGameTemplateCharacter::Move);
@@ -220,139 +712,395 @@ void AGameTemplateCharacter::SetupPlayerInputComponent(class UInputComponent* Pl
 		// @NOTE: You can add more actions in here
 	}
 
-	// Set up ability system controls
-	ResetBinds();
-	for (const auto& Ability : MappedAbilities)
+	// Set up ability system controls, bindings already live on this component are kept
+	for (auto& InputBinding : MappedAbilities)
 	{
-		UInputAction* InputAction = Ability.Key;
+		BindAbilityInput(InputBinding.Key, InputBinding.Value);
+	}
+#endif
+}
+
+void AGameTemplateCharacter::BindAbilityInput(UInputAction* InputAction, FAbilityInputBinding& Binding)
+{
+	if (!EnhancedInputComponent || Binding.BoundInputComponent.Get() == EnhancedInputComponent)
+	{
+		return;
+	}
+
+	// Drop the handles of a previous input component that is still alive
+	UnbindAbilityInput(Binding);
+
+	// Pressed event
+	Binding.OnPressedHandle = EnhancedInputComponent->BindAction(InputAction, ETriggerEvent::Started, this, &AGameTemplateCharacter::OnAbilityInputPressed, InputAction).GetHandle();
 
-		// Pressed event
-		EnhancedInputComponent->BindAction(InputAction,ETriggerEvent::Started,this,&AGameTemplateCharacter::OnAbilityInputPressed,InputAction);
+	// Released event
+	Binding.OnReleasedHandle = EnhancedInputComponent->BindAction(InputAction, ETriggerEvent::Completed, this, &AGameTemplateCharacter::OnAbilityInputReleased, InputAction).GetHandle();
 
-		// Release event
-		EnhancedInputComponent->BindAction(InputAction,ETriggerEvent::Completed,this,&AGameTemplateCharacter::OnAbilityInputReleased,InputAction);
+	Binding.BoundInputComponent = EnhancedInputComponent;
+}
+
+void AGameTemplateCharacter::UnbindAbilityInput(FAbilityInputBinding& Binding)
+{
+	if (UEnhancedInputComponent* BoundInputComponent = Binding.BoundInputComponent.Get())
+	{
+		BoundInputComponent->RemoveBindingByHandle(Binding.OnPressedHandle);
+		BoundInputComponent->RemoveBindingByHandle(Binding.OnReleasedHandle);
 	}
-	// Run ability system setup
-	RunAbilitySystemSetup();
+
+	Binding.BoundInputComponent.Reset();
+	Binding.OnPressedHandle = 0;
+	Binding.OnReleasedHandle = 0;
 }
 
-void AGameTemplateCharacter::ResetBinds()
+void AGameTemplateCharacter::OnAbilityInputPressed(UInputAction* InputAction)
 {
-	for (auto& InputBinding : MappedAbilities)
+	RecordInput(ETemplateRecordedInputType::AbilityPressed, InputAction);
+
+	if (AbilitySystemComponent)
 	{
-		if (EnhancedInputComponent)
+		using namespace AbilityInputBindingImpl;
+
+		FAbilityInputBinding* FoundBinding = MappedAbilities.Find(InputAction);
+		if (FoundBinding)
 		{
-			EnhancedInputComponent->RemoveBindingByHandle(InputBinding.Value.OnPressedHandle);
-			EnhancedInputComponent->RemoveBindingByHandle(InputBinding.Value.OnReleasedHandle);
+			FoundBinding->bInputHeld = true;
+
+			// Hold a blocked press until the blocking condition clears
+			const bool bBlocked = PressAbilityInput(*FoundBinding);
+			FoundBinding->BufferedPressExpireTime = (bBlocked && FoundBinding->InputBufferTime > 0.0f) ? GetWorld()->GetTimeSeconds() + FoundBinding->InputBufferTime / 1000.0 : 0.0;
+			UpdateBufferedInputListeners();
 		}
+	}
+}
 
-		if (AbilitySystemComponent)
+bool AGameTemplateCharacter::PressAbilityInput(FAbilityInputBinding& Binding)
+{
+	using namespace AbilityInputBindingImpl;
+
+	const uint32 NumActivations = AbilitySystemComponent->GetNumActivations();
+	const uint32 NumActivationFailures = AbilitySystemComponent->GetNumActivationFailures();
+
+	// Bound abilities share their InputID, press each ID once
+	TArray<int32, TInlineAllocator<4>> PressedInputIDs;
+	for (FGameplayAbilitySpecHandle AbilityHandle : Binding.BoundAbilitiesStack)
+	{
+		FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
+		if (FoundAbility != nullptr && ensure(HasInputID(*FoundAbility)))
 		{
-			const int32 ExpectedInputID = InputBinding.Value.InputID;
+			PressedInputIDs.AddUnique(FoundAbility->InputID);
+		}
+	}
 
-			for (FGameplayAbilitySpecHandle AbilityHandle : InputBinding.Value.BoundAbilitiesStack)
-			{
-				FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
-				if (FoundAbility && FoundAbility->InputID == ExpectedInputID)
-				{
-					FoundAbility->InputID = AbilityInputBindingImpl::InvalidInputID;
-				}
-			}
+	for (const int32 InputID : PressedInputIDs)
+	{
+		AbilitySystemComponent->AbilityLocalInputPressed(InputID);
+	}
+
+	// Blocked only when an activation failed locally and none succeeded. Presses forwarded to the server
+	// (server only or non predicted abilities on clients) or sent to active abilities count as handled
+	return AbilitySystemComponent->GetNumActivationFailures() != NumActivationFailures && AbilitySystemComponent->GetNumActivations() == NumActivations;
+}
+
+void AGameTemplateCharacter::OnAbilityInputReleased(UInputAction* InputAction)
+{
+	RecordInput(ETemplateRecordedInputType::AbilityReleased, InputAction);
+
+	if (AbilitySystemComponent)
+	{
+		FAbilityInputBinding* FoundBinding = MappedAbilities.Find(InputAction);
+		if (FoundBinding)
+		{
+			// A buffered press outlives a tap, it is kept until its window expires
+			FoundBinding->bInputHeld = false;
+			ReleaseAbilityInput(*FoundBinding);
 		}
 	}
 }
 
-void AGameTemplateCharacter::RunAbilitySystemSetup()
+void AGameTemplateCharacter::ReleaseAbilityInput(FAbilityInputBinding& Binding)
 {
-	for (auto& InputBinding : MappedAbilities)
+	using namespace AbilityInputBindingImpl;
+
+	TArray<int32, TInlineAllocator<4>> ReleasedInputIDs;
+	for (FGameplayAbilitySpecHandle AbilityHandle : Binding.BoundAbilitiesStack)
 	{
-		const int32 NewInputID = AbilityInputBindingImpl::GetNextInputID();
-		InputBinding.Value.InputID = NewInputID;
+		FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
+		if (FoundAbility != nullptr && ensure(HasInputID(*FoundAbility)))
+		{
+			ReleasedInputIDs.AddUnique(FoundAbility->InputID);
+		}
+	}
 
-		for (FGameplayAbilitySpecHandle AbilityHandle : InputBinding.Value.BoundAbilitiesStack)
+	for (const int32 InputID : ReleasedInputIDs)
+	{
+		AbilitySystemComponent->AbilityLocalInputReleased(InputID);
+	}
+}
+
+void AGameTemplateCharacter::RemoveEntry(UInputAction* InputAction)
+{
+	if (FAbilityInputBinding* Bindings = MappedAbilities.Find(InputAction))
+	{
+		UnbindAbilityInput(*Bindings);
+
+		for (FGameplayAbilitySpecHandle AbilityHandle : Bindings->BoundAbilitiesStack)
 		{
-			FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
-			if (FoundAbility != nullptr)
+			using namespace AbilityInputBindingImpl;
+
+			FGameplayAbilitySpec* AbilitySpec = FindAbilitySpec(AbilityHandle);
+			if (AbilitySpec && AbilitySpec->InputID == Bindings->InputID)
 			{
-				FoundAbility->InputID = NewInputID;
+				AbilitySpec->InputID = InvalidInputID;
 			}
 		}
+		MappedAbilities.Remove(InputAction);
 	}
 }
 
-void AGameTemplateCharacter::OnAbilityInputPressed(UInputAction* InputAction)
+void AGameTemplateCharacter::HandleAbilitySpecGiven(FGameplayAbilitySpec& AbilitySpec)
 {
-	// The AbilitySystemComponent may not have been valid when we first bound input... try again.
-	
-	if (!AbilitySystemComponent)
+	using namespace AbilityInputBindingImpl;
+
+	// Specs the server left unbound have no InputID to press
+	UTemplateGameplayAbilitySet* AbilitySet = Cast<UTemplateGameplayAbilitySet>(AbilitySpec.SourceObject.Get());
+	if (!AbilitySet || !HasInputID(AbilitySpec))
 	{
-		RunAbilitySystemSetup();
+		return;
 	}
 
-	if (AbilitySystemComponent)
+	const FTemplateAbilitySetGrantData::FAbilityEntry* AbilityEntry = AbilitySet->FindAbilityEntry(AbilitySpec);
+	if (AbilityEntry && AbilityEntry->InputAction)
 	{
-		using namespace AbilityInputBindingImpl;
+		SetInputBinding(AbilityEntry->InputAction, AbilitySpec, AbilityEntry->InputBufferTime);
+	}
+}
 
-		FAbilityInputBinding* FoundBinding = MappedAbilities.Find(InputAction);
-		if (FoundBinding)
+void AGameTemplateCharacter::HandleAbilitySpecRemoved(FGameplayAbilitySpec& AbilitySpec)
+{
+	ClearInputBinding(AbilitySpec);
+}
+
+UEnhancedInputLocalPlayerSubsystem* AGameTemplateCharacter::GetMappingContextSubsystem(bool bAdd)
+{
+	if (const APlayerController* PlayerController = Cast<APlayerController>(Controller))
+	{
+		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
 		{
-			for (FGameplayAbilitySpecHandle AbilityHandle : FoundBinding->BoundAbilitiesStack)
-			{
-				FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
-				if (FoundAbility != nullptr && ensure(FoundAbility->InputID != InvalidInputID))
-				{
-					AbilitySystemComponent->AbilityLocalInputPressed(FoundAbility->InputID);
-				}
-			}
+			SetMappingContextSubsystem(Subsystem);
+			return Subsystem;
 		}
 	}
+
+	// Contexts are only added for the local player controlling this pawn, the one they were added to takes them back
+	return bAdd ? nullptr : MappingContextSubsystem.Get();
 }
 
-void AGameTemplateCharacter::OnAbilityInputReleased(UInputAction* InputAction)
+void AGameTemplateCharacter::SetMappingContextSubsystem(UEnhancedInputLocalPlayerSubsystem* Subsystem)
 {
-	if (AbilitySystemComponent)
+	UEnhancedInputLocalPlayerSubsystem* PreviousSubsystem = MappingContextSubsystem.Get();
+	if (Subsystem == PreviousSubsystem)
 	{
-		using namespace AbilityInputBindingImpl;
+		return;
+	}
 
-		FAbilityInputBinding* FoundBinding = MappedAbilities.Find(InputAction);
-		if (FoundBinding)
+	// Only bound while this pawn holds contexts of the player, so each rebuild is counted once
+	if (PreviousSubsystem)
+	{
+		PreviousSubsystem->ControlMappingsRebuiltDelegate.RemoveDynamic(this, &AGameTemplateCharacter::HandleControlMappingsRebuilt);
+	}
+	if (Subsystem)
+	{
+		Subsystem->ControlMappingsRebuiltDelegate.AddUniqueDynamic(this, &AGameTemplateCharacter::HandleControlMappingsRebuilt);
+	}
+	MappingContextSubsystem = Subsystem;
+}
+
+void AGameTemplateCharacter::QueueMappingContextChanges(UTemplateGameplayAbilitySet* AbilitySet, bool bAdd)
+{
+	// Only locally controlled characters have mapping contexts
+	if (!AbilitySet || !GetMappingContextSubsystem(bAdd))
+	{
+		return;
+	}
+
+	for (const FTemplateBakedMappingContextEntry& MappingContext : AbilitySet->GetGrantData().InputMappingContexts)
+	{
+		// Sets may share a context, it is only added for the first set and removed with the last one
+		int32& RefCount = MappingContextRefCounts.FindOrAdd(MappingContext.MappingContext);
+		const int32 PreviousRefCount = RefCount;
+		RefCount = FMath::Max(0, RefCount + (bAdd ? 1 : -1));
+
+		const bool bChanged = (PreviousRefCount == 0) != (RefCount == 0);
+		if (RefCount == 0)
+		{
+			MappingContextRefCounts.Remove(MappingContext.MappingContext);
+		}
+		if (!bChanged)
+		{
+			continue;
+		}
+
+		// A later change to the same context replaces the earlier one, so swapping sets back and forth costs nothing
+		FPendingMappingContextChange* PendingChange = PendingMappingContextChanges.FindByPredicate(
+			[&MappingContext](const FPendingMappingContextChange& Candidate) { return Candidate.MappingContext == MappingContext.MappingContext; });
+		if (!PendingChange)
+		{
+			PendingChange = &PendingMappingContextChanges.AddDefaulted_GetRef();
+			PendingChange->MappingContext = MappingContext.MappingContext;
+		}
+		PendingChange->Priority = MappingContext.Priority;
+		PendingChange->bAdd = bAdd;
+	}
+
+	if (PendingMappingContextChanges.Num() > 0 && !MappingContextFlushTimerHandle.IsValid())
+	{
+		MappingContextFlushTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &AGameTemplateCharacter::FlushMappingContextChanges);
+	}
+}
+
+void AGameTemplateCharacter::RemoveClientMappingContexts()
+{
+	if (bAddedClientMappingContexts)
+	{
+		bAddedClientMappingContexts = false;
+		for (UTemplateGameplayAbilitySet* AbilitySet : AbilitySets)
+		{
+			QueueMappingContextChanges(AbilitySet, false);
+		}
+	}
+}
+
+void AGameTemplateCharacter::FlushMappingContextChanges()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateCharacter_FlushMappingContexts);
+
+	GetWorldTimerManager().ClearTimer(MappingContextFlushTimerHandle);
+
+	if (UEnhancedInputLocalPlayerSubsystem* Subsystem = MappingContextSubsystem.Get())
+	{
+		for (int32 Index = 0; Index < PendingMappingContextChanges.Num(); ++Index)
 		{
-			for (FGameplayAbilitySpecHandle AbilityHandle : FoundBinding->BoundAbilitiesStack)
+			const FPendingMappingContextChange& PendingChange = PendingMappingContextChanges[Index];
+
+			// Only the last change rebuilds the control mappings, right away so the rebuild is part of this flush
+			FModifyContextOptions Options;
+			Options.bForceImmediately = Index == PendingMappingContextChanges.Num() - 1;
+
+			if (PendingChange.bAdd)
 			{
-				FGameplayAbilitySpec* FoundAbility = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
-				if (FoundAbility != nullptr && ensure(FoundAbility->InputID != InvalidInputID))
-				{
-					AbilitySystemComponent->AbilityLocalInputReleased(FoundAbility->InputID);
-				}
+				Subsystem->AddMappingContext(PendingChange.MappingContext, PendingChange.Priority, Options);
+			}
+			else
+			{
+				Subsystem->RemoveMappingContext(PendingChange.MappingContext, Options);
 			}
 		}
 	}
+
+	PendingMappingContextChanges.Reset();
+
+	// Every context went back to a player that no longer controls this pawn, stop listening to its rebuilds
+	if (MappingContextRefCounts.Num() == 0 && !IsLocallyControlled())
+	{
+		SetMappingContextSubsystem(nullptr);
+	}
 }
 
-void AGameTemplateCharacter::RemoveEntry(UInputAction* InputAction)
+void AGameTemplateCharacter::HandleControlMappingsRebuilt()
 {
-	if (FAbilityInputBinding* Bindings = MappedAbilities.Find(InputAction))
+	INC_DWORD_STAT(STAT_TemplateCharacter_ControlMappingsRebuilds);
+}
+
+void AGameTemplateCharacter::RetryBufferedAbilityInputs()
+{
+	// Activating an ability changes tags too, don't retry from inside a retry
+	if (bRetryingBufferedInput || !AbilitySystemComponent)
 	{
-		if (EnhancedInputComponent)
+		return;
+	}
+	TGuardValue<bool> RetryGuard(bRetryingBufferedInput, true);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (auto& InputBinding : MappedAbilities)
+	{
+		FAbilityInputBinding& Binding = InputBinding.Value;
+		if (Binding.BufferedPressExpireTime <= Now)
 		{
-			EnhancedInputComponent->RemoveBindingByHandle(Bindings->OnPressedHandle);
-			EnhancedInputComponent->RemoveBindingByHandle(Bindings->OnReleasedHandle);
+			Binding.BufferedPressExpireTime = 0.0;
+			continue;
 		}
 
-		for (FGameplayAbilitySpecHandle AbilityHandle : Bindings->BoundAbilitiesStack)
+		// Through the input path, so the retry sets InputPressed, fires the input events and batches its RPCs like a live press
+		if (!PressAbilityInput(Binding))
 		{
-			using namespace AbilityInputBindingImpl;
+			Binding.BufferedPressExpireTime = 0.0;
 
-			FGameplayAbilitySpec* AbilitySpec = FindAbilitySpec(AbilityHandle);
-			if (AbilitySpec && AbilitySpec->InputID == Bindings->InputID)
+			// The key went up while the press was buffered, release what just activated so hold abilities end
+			if (!Binding.bInputHeld)
 			{
-				AbilitySpec->InputID = InvalidInputID;
+				ReleaseAbilityInput(Binding);
 			}
 		}
-		MappedAbilities.Remove(InputAction);
+	}
+
+	UpdateBufferedInputListeners();
+}
+
+void AGameTemplateCharacter::UpdateBufferedInputListeners()
+{
+	// Drop expired presses and find when the next one expires
+	const double Now = GetWorld()->GetTimeSeconds();
+	double NextExpireTime = 0.0;
+	for (auto& InputBinding : MappedAbilities)
+	{
+		FAbilityInputBinding& Binding = InputBinding.Value;
+		if (Binding.BufferedPressExpireTime <= Now)
+		{
+			Binding.BufferedPressExpireTime = 0.0;
+		}
+		else if (NextExpireTime == 0.0 || Binding.BufferedPressExpireTime < NextExpireTime)
+		{
+			NextExpireTime = Binding.BufferedPressExpireTime;
+		}
+	}
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (NextExpireTime > 0.0 && AbilitySystemComponent)
+	{
+		if (!BufferedInputTagChangedHandle.IsValid())
+		{
+			BufferedInputTagChangedHandle = AbilitySystemComponent->RegisterGenericGameplayTagEvent().AddUObject(this, &AGameTemplateCharacter::HandleBufferedInputTagChanged);
+			BufferedInputAbilityEndedHandle = AbilitySystemComponent->AbilityEndedCallbacks.AddUObject(this, &AGameTemplateCharacter::HandleBufferedInputAbilityEnded);
+		}
+		TimerManager.SetTimer(BufferedInputExpireTimerHandle, this, &AGameTemplateCharacter::UpdateBufferedInputListeners, static_cast<float>(NextExpireTime - Now), false);
+	}
+	else
+	{
+		if (BufferedInputTagChangedHandle.IsValid() && AbilitySystemComponent)
+		{
+			AbilitySystemComponent->RegisterGenericGameplayTagEvent().Remove(BufferedInputTagChangedHandle);
+			AbilitySystemComponent->AbilityEndedCallbacks.Remove(BufferedInputAbilityEndedHandle);
+		}
+		BufferedInputTagChangedHandle.Reset();
+		BufferedInputAbilityEndedHandle.Reset();
+		TimerManager.ClearTimer(BufferedInputExpireTimerHandle);
 	}
 }
 
+void AGameTemplateCharacter::HandleBufferedInputTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	// Cooldowns and blocking tags clear when their tag is removed
+	if (NewCount == 0)
+	{
+		RetryBufferedAbilityInputs();
+	}
+}
+
+void AGameTemplateCharacter::HandleBufferedInputAbilityEnded(UGameplayAbility* Ability)
+{
+	RetryBufferedAbilityInputs();
+}
+
 FGameplayAbilitySpec* AGameTemplateCharacter::FindAbilitySpec(FGameplayAbilitySpecHandle Handle)
 {
 	FGameplayAbilitySpec* FoundAbility = nullptr;
@@ -363,6 +1111,77 @@ FGameplayAbilitySpec* AGameTemplateCharacter::FindAbilitySpec(FGameplayAbilitySp
 	return FoundAbility;
 }
 
+void AGameTemplateCharacter::AccumulateAbilityMemoryUsage(FTemplateAbilityMemoryUsage& Usage) const
+{
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->AccumulateMemoryUsage(Usage);
+	}
+
+	Usage.InputBindings += MappedAbilities.GetAllocatedSize();
+	for (const auto& InputBinding : MappedAbilities)
+	{
+		Usage.InputBindings += InputBinding.Value.BoundAbilitiesStack.GetAllocatedSize();
+	}
+
+	for (const auto& GrantedAbilitySet : GrantedAbilitySets)
+	{
+		Usage.AbilitySets.Emplace(GetNameSafe(GrantedAbilitySet.Key), sizeof(FTemplateAbilitySetGrantedHandles) + GrantedAbilitySet.Value.GetAllocatedSize());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Significance
+
+void AGameTemplateCharacter::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TemplateCharacter_UpdateSignificance);
+
+	if (!AbilitySystemComponent || SignificanceBuckets.Num() == 0)
+	{
+		return;
+	}
+
+	int32 NewBucketIndex = 0;
+	if (CVarSignificanceThrottling.GetValueOnGameThread() && !IsLocallyControlled())
+	{
+		// Distance to the closest player, remote players on the server and the local one on clients
+		float ClosestDistanceSquared = TNumericLimits<float>::Max();
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (const APlayerController* PlayerController = It->Get())
+			{
+				ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(PlayerController->GetFocalLocation(), GetActorLocation()));
+			}
+		}
+
+		NewBucketIndex = SignificanceBuckets.Num() - 1;
+		for (int32 BucketIndex = 0; BucketIndex < SignificanceBuckets.Num(); ++BucketIndex)
+		{
+			if (ClosestDistanceSquared < FMath::Square(SignificanceBuckets[BucketIndex].MaxDistance))
+			{
+				NewBucketIndex = BucketIndex;
+				break;
+			}
+		}
+	}
+
+	if (NewBucketIndex != SignificanceBucketIndex)
+	{
+		if (SignificanceBucketIndex > 0)
+		{
+			DEC_DWORD_STAT(STAT_TemplateCharacter_ThrottledAbilitySystems);
+		}
+		if (NewBucketIndex > 0)
+		{
+			INC_DWORD_STAT(STAT_TemplateCharacter_ThrottledAbilitySystems);
+		}
+
+		SignificanceBucketIndex = NewBucketIndex;
+		AbilitySystemComponent->ApplySignificanceBucket(SignificanceBuckets[NewBucketIndex]);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Input functionality
 
@@ -370,6 +1189,7 @@ void AGameTemplateCharacter::Move(const FInputActionValue& Value)
 {
 	// input is a Vector2D
 	FVector2D MovementVector = Value.Get<FVector2D>();
+	RecordInput(ETemplateRecordedInputType::Move, nullptr, MovementVector);
 
 	if (Controller != nullptr)
 	{
@@ -393,6 +1213,7 @@ void AGameTemplateCharacter::Look(const FInputActionValue& Value)
 {
 	// input is a Vector2D
 	FVector2D LookAxisVector = Value.Get<FVector2D>();
+	RecordInput(ETemplateRecordedInputType::Look, nullptr, LookAxisVector);
 
 	if (Controller != nullptr)
 	{
@@ -402,6 +1223,53 @@ void AGameTemplateCharacter::Look(const FInputActionValue& Value)
 	}
 }
 
+void AGameTemplateCharacter::OnJumpInputPressed()
+{
+	RecordInput(ETemplateRecordedInputType::JumpPressed);
+	Jump();
+}
 
+void AGameTemplateCharacter::OnJumpInputReleased()
+{
+	RecordInput(ETemplateRecordedInputType::JumpReleased);
+	StopJumping();
+}
 
+//////////////////////////////////////////////////////////////////////////
+// Input recording
 
+void AGameTemplateCharacter::RecordInput(ETemplateRecordedInputType Type, const UInputAction* InputAction, const FVector2D& Value)
+{
+	if (UTemplateInputReplaySubsystem* Recorder = InputRecorder.Get())
+	{
+		Recorder->RecordInput(Type, InputAction, Value);
+	}
+}
+
+void AGameTemplateCharacter::InjectRecordedInput(ETemplateRecordedInputType Type, UInputAction* InputAction, const FVector2D& Value)
+{
+	// Goes through the same handlers as live input, so replayed input exercises the same paths
+	switch (Type)
+	{
+	case ETemplateRecordedInputType::Move:
+		Move(FInputActionValue(Value));
+		break;
+	case ETemplateRecordedInputType::Look:
+		Look(FInputActionValue(Value));
+		break;
+	case ETemplateRecordedInputType::JumpPressed:
+		OnJumpInputPressed();
+		break;
+	case ETemplateRecordedInputType::JumpReleased:
+		OnJumpInputReleased();
+		break;
+	case ETemplateRecordedInputType::AbilityPressed:
+		OnAbilityInputPressed(InputAction);
+		break;
+	case ETemplateRecordedInputType::AbilityReleased:
+		OnAbilityInputReleased(InputAction);
+		break;
+	default:
+		break;
+	}
+}
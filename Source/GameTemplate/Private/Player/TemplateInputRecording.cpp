@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/TemplateInputRecording.h"
+
+#include "InputAction.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+uint16 FTemplateInputStream::FindOrAddInputAction(const UInputAction* InputAction)
+{
+	const FString InputActionPath = GetPathNameSafe(InputAction);
+
+	const int32 ExistingIndex = InputActionPaths.Find(InputActionPath);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return static_cast<uint16>(ExistingIndex);
+	}
+
+	check(InputActionPaths.Num() < MAX_uint16);
+	return static_cast<uint16>(InputActionPaths.Add(InputActionPath));
+}
+
+void FTemplateInputStream::Serialize(FArchive& Ar)
+{
+	uint32 StreamMagic = Magic;
+	uint32 StreamVersion = Version;
+	Ar << StreamMagic;
+	Ar << StreamVersion;
+
+	if (Ar.IsLoading() && (StreamMagic != Magic || StreamVersion != Version))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << InputActionPaths;
+
+	int32 NumEvents = Events.Num();
+	Ar << NumEvents;
+
+	if (Ar.IsLoading())
+	{
+		// Every event takes at least two bytes, reject counts the stream can't hold
+		if (NumEvents < 0 || NumEvents > Ar.TotalSize())
+		{
+			Ar.SetError();
+			return;
+		}
+		Events.SetNum(NumEvents);
+	}
+
+	uint32 PreviousFrame = 0;
+	for (FTemplateRecordedInputEvent& Event : Events)
+	{
+		uint32 FrameDelta = Event.Frame - PreviousFrame;
+		Ar.SerializeIntPacked(FrameDelta);
+		Event.Frame = PreviousFrame + FrameDelta;
+		PreviousFrame = Event.Frame;
+
+		uint8 Type = static_cast<uint8>(Event.Type);
+		Ar << Type;
+
+		// A corrupt stream or one written by a newer build
+		if (Type >= static_cast<uint8>(ETemplateRecordedInputType::Count))
+		{
+			Ar.SetError();
+			return;
+		}
+		Event.Type = static_cast<ETemplateRecordedInputType>(Type);
+
+		switch (Event.Type)
+		{
+		case ETemplateRecordedInputType::Move:
+		case ETemplateRecordedInputType::Look:
+			Ar << Event.Value.X;
+			Ar << Event.Value.Y;
+			break;
+
+		case ETemplateRecordedInputType::AbilityPressed:
+		case ETemplateRecordedInputType::AbilityReleased:
+			{
+				uint32 InputActionIndex = Event.InputActionIndex;
+				Ar.SerializeIntPacked(InputActionIndex);
+				Event.InputActionIndex = static_cast<uint16>(InputActionIndex);
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		if (Ar.IsError())
+		{
+			return;
+		}
+	}
+}
+
+bool FTemplateInputStream::SaveToFile(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Serialize(Writer);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+bool FTemplateInputStream::LoadFromFile(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader);
+
+	return !Reader.IsError();
+}
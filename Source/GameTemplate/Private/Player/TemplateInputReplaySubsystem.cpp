@@ -0,0 +1,298 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/TemplateInputReplaySubsystem.h"
+
+#include "EngineUtils.h"
+#include "GameTemplate.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "InputAction.h"
+#include "Misc/Paths.h"
+#include "Player/GameTemplateCharacter.h"
+
+namespace TemplateInputReplayImpl
+{
+	/** Relative names are streams in Saved/InputRecordings **/
+	static FString ResolveStreamPath(const FString& FileName)
+	{
+		return FPaths::IsRelative(FileName) ? FPaths::ProjectSavedDir() / TEXT("InputRecordings") / FileName + TEXT(".tinput") : FileName;
+	}
+}
+
+void UTemplateInputReplaySubsystem::StartRecording(AGameTemplateCharacter* Character)
+{
+	check(Character);
+
+	if (AGameTemplateCharacter* PreviousCharacter = RecordingCharacter.Get())
+	{
+		PreviousCharacter->SetInputRecorder(nullptr);
+	}
+
+	Recording = FTemplateInputStream();
+	RecordingStartFrame = GFrameCounter;
+	RecordingCharacter = Character;
+	Character->SetInputRecorder(this);
+}
+
+bool UTemplateInputReplaySubsystem::StopRecording(const FString& FilePath)
+{
+	if (AGameTemplateCharacter* Character = RecordingCharacter.Get())
+	{
+		Character->SetInputRecorder(nullptr);
+	}
+	RecordingCharacter.Reset();
+
+	const bool bSaved = Recording.SaveToFile(FilePath);
+	UE_LOG(ProjectLog, Display, TEXT("Saved %d input events to [%s]: %s"), Recording.Events.Num(), *FilePath, bSaved ? TEXT("ok") : TEXT("failed"));
+
+	Recording = FTemplateInputStream();
+	return bSaved;
+}
+
+void UTemplateInputReplaySubsystem::RecordInput(ETemplateRecordedInputType Type, const UInputAction* InputAction, const FVector2D& Value)
+{
+	FTemplateRecordedInputEvent& Event = Recording.Events.AddDefaulted_GetRef();
+	Event.Frame = static_cast<uint32>(GFrameCounter - RecordingStartFrame);
+	Event.Type = Type;
+	Event.Value = FVector2f(Value);
+
+	if (InputAction)
+	{
+		Event.InputActionIndex = Recording.FindOrAddInputAction(InputAction);
+	}
+}
+
+bool UTemplateInputReplaySubsystem::StartReplay(const FString& FilePath, int32 NumCharacters, bool bLoop)
+{
+	StopReplay();
+
+	if (!Replay.LoadFromFile(FilePath))
+	{
+		UE_LOG(ProjectLog, Error, TEXT("Input stream [%s] could not be loaded"), *FilePath);
+		return false;
+	}
+
+	for (const FString& InputActionPath : Replay.InputActionPaths)
+	{
+		ReplayInputActions.Add(LoadObject<UInputAction>(nullptr, *InputActionPath));
+	}
+
+	ReplayNumCharacters = NumCharacters;
+	GatherReplayCharacters(NumCharacters);
+
+	ReplayNextEvent = 0;
+	ReplayFrame = 0;
+	bReplayLoop = bLoop;
+	bReplaying = true;
+
+	UE_LOG(ProjectLog, Display, TEXT("Replaying %d input events from [%s] into %d characters"), Replay.Events.Num(), *FilePath, ReplayCharacters.Num());
+	return true;
+}
+
+void UTemplateInputReplaySubsystem::StopReplay()
+{
+	bReplaying = false;
+	Replay = FTemplateInputStream();
+	ReplayCharacters.Reset();
+	ReplayInputActions.Reset();
+}
+
+void UTemplateInputReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bReplaying)
+	{
+		return;
+	}
+
+	if (ReplayCharacters.Num() == 0)
+	{
+		GatherReplayCharacters(ReplayNumCharacters);
+		if (ReplayCharacters.Num() == 0)
+		{
+			return;
+		}
+	}
+
+	// Dispatch every event recorded up to the current frame
+	while (ReplayNextEvent < Replay.Events.Num() && Replay.Events[ReplayNextEvent].Frame <= ReplayFrame)
+	{
+		const FTemplateRecordedInputEvent& Event = Replay.Events[ReplayNextEvent++];
+		UInputAction* InputAction = ReplayInputActions.IsValidIndex(Event.InputActionIndex) ? ReplayInputActions[Event.InputActionIndex].Get() : nullptr;
+
+		for (const TWeakObjectPtr<AGameTemplateCharacter>& Character : ReplayCharacters)
+		{
+			if (Character.IsValid())
+			{
+				Character->InjectRecordedInput(Event.Type, InputAction, FVector2D(Event.Value));
+			}
+		}
+	}
+
+	++ReplayFrame;
+
+	if (ReplayNextEvent >= Replay.Events.Num())
+	{
+		if (bReplayLoop)
+		{
+			ReplayNextEvent = 0;
+			ReplayFrame = 0;
+		}
+		else
+		{
+			StopReplay();
+		}
+	}
+}
+
+TStatId UTemplateInputReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTemplateInputReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UTemplateInputReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+#if !UE_BUILD_SHIPPING
+	// Headless processes start replaying from the command line, e.g. -TemplateInputReplay=Soak -TemplateInputReplayCharacters=8
+	FString FileName;
+	if (InWorld.IsGameWorld() && FParse::Value(FCommandLine::Get(), TEXT("TemplateInputReplay="), FileName))
+	{
+		int32 NumCharacters = 1;
+		FParse::Value(FCommandLine::Get(), TEXT("TemplateInputReplayCharacters="), NumCharacters);
+
+		StartReplay(TemplateInputReplayImpl::ResolveStreamPath(FileName), FMath::Max(1, NumCharacters), true);
+	}
+#endif
+}
+
+void UTemplateInputReplaySubsystem::Deinitialize()
+{
+	if (AGameTemplateCharacter* Character = RecordingCharacter.Get())
+	{
+		Character->SetInputRecorder(nullptr);
+	}
+	StopReplay();
+
+	Super::Deinitialize();
+}
+
+void UTemplateInputReplaySubsystem::GatherReplayCharacters(int32 NumCharacters)
+{
+	UWorld* World = GetWorld();
+	const AGameModeBase* GameMode = World->GetAuthGameMode();
+
+	// Locally controlled characters first, so a client drives its own pawn. Pawns of remote players are driven by their client
+	TArray<AGameTemplateCharacter*> Candidates;
+	for (TActorIterator<AGameTemplateCharacter> It(World); It; ++It)
+	{
+		if (*It != RecordingCharacter.Get() && (It->IsLocallyControlled() || (GameMode && !It->IsPlayerControlled())))
+		{
+			Candidates.Add(*It);
+		}
+	}
+	Candidates.StableSort([](const AGameTemplateCharacter& A, const AGameTemplateCharacter& B) { return A.IsLocallyControlled() && !B.IsLocallyControlled(); });
+
+	for (int32 Index = 0; Index < Candidates.Num() && ReplayCharacters.Num() < NumCharacters; ++Index)
+	{
+		ReplayCharacters.Add(Candidates[Index]);
+	}
+
+	// Spawn AI controlled characters for the rest, only the authority can
+	UClass* PawnClass = Candidates.Num() > 0 ? Candidates[0]->GetClass() : (GameMode ? GameMode->DefaultPawnClass.Get() : nullptr);
+	if (!GameMode || !PawnClass || !PawnClass->IsChildOf<AGameTemplateCharacter>())
+	{
+		return;
+	}
+
+	const FVector Origin = Candidates.Num() > 0 ? Candidates[0]->GetActorLocation() : FVector::ZeroVector;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 SpawnIndex = 0; ReplayCharacters.Num() < NumCharacters; ++SpawnIndex)
+	{
+		// Spread spawned characters on a grid around the origin
+		const FVector Offset(300.0f * (SpawnIndex % 32), 300.0f * (SpawnIndex / 32 + 1), 0.0f);
+
+		AGameTemplateCharacter* Character = World->SpawnActor<AGameTemplateCharacter>(PawnClass, Origin + Offset, FRotator::ZeroRotator, SpawnParameters);
+		if (!Character)
+		{
+			break;
+		}
+
+		Character->SpawnDefaultController();
+		ReplayCharacters.Add(Character);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace TemplateInputReplayCommands
+{
+	static FString ResolveStreamPath(const TArray<FString>& Args)
+	{
+		return TemplateInputReplayImpl::ResolveStreamPath(Args.IsValidIndex(0) ? Args[0] : TEXT("Default"));
+	}
+
+	static FAutoConsoleCommandWithWorld StartRecordCommand(
+		TEXT("Template.Input.Record"),
+		TEXT("Starts recording the input of the first locally controlled character"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			UTemplateInputReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTemplateInputReplaySubsystem>() : nullptr;
+			if (!Subsystem)
+			{
+				return;
+			}
+
+			for (TActorIterator<AGameTemplateCharacter> It(World); It; ++It)
+			{
+				if (It->IsLocallyControlled())
+				{
+					Subsystem->StartRecording(*It);
+					return;
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs StopRecordCommand(
+		TEXT("Template.Input.StopRecord"),
+		TEXT("Stops recording and saves the stream. Args: [FileName=Default]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UTemplateInputReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTemplateInputReplaySubsystem>() : nullptr)
+			{
+				Subsystem->StopRecording(ResolveStreamPath(Args));
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs ReplayCommand(
+		TEXT("Template.Input.Replay"),
+		TEXT("Replays a recorded stream into N characters. Args: [FileName=Default] [NumCharacters=1] [Loop=0]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UTemplateInputReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTemplateInputReplaySubsystem>() : nullptr)
+			{
+				const int32 NumCharacters = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1;
+				const bool bLoop = Args.IsValidIndex(2) && FCString::Atoi(*Args[2]) != 0;
+				Subsystem->StartReplay(ResolveStreamPath(Args), NumCharacters, bLoop);
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld StopReplayCommand(
+		TEXT("Template.Input.StopReplay"),
+		TEXT("Stops the running replay"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UTemplateInputReplaySubsystem* Subsystem = World ? World->GetSubsystem<UTemplateInputReplaySubsystem>() : nullptr)
+			{
+				Subsystem->StopReplay();
+			}
+		}));
+}
+
+#endif
@@ -9,7 +9,7 @@
 
 /**
  * Example class which shows how to implement a new attribute set
- * (Attribute examples include: stamina)
+ * (Attribute examples include: stamina, energy as a rate attribute)
  */
 UCLASS(BlueprintType)
 class GAMETEMPLATE_API UExampleAttributeSet : public UTemplateAttributeSet
@@ -23,7 +23,37 @@ public:
 	FGameplayAttributeData Stamina;
 	ATTRIBUTE_ACCESSORS(UExampleAttributeSet, Stamina);
 
-	/** Override this function to clamp an attribute value **/
-	virtual void PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const override;
-	
+	/** Regenerates or drains at a constant rate, only value and rate changes replicate **/
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing=OnRep_Energy, Category="Attributes")
+	FTemplateRateAttributeData Energy;
+
+	/**
+	 * Meta attribute gameplay effects modify instead of Energy, which they can't target. Executions (instant and periodic effects)
+	 * are added to Energy on the authority and it goes back to 0, duration modifiers on it do nothing
+	 */
+	UPROPERTY(BlueprintReadOnly, Category="Attributes")
+	FGameplayAttributeData EnergyChange;
+	ATTRIBUTE_ACCESSORS(UExampleAttributeSet, EnergyChange);
+
+	float GetEnergy() const { return GetRateAttributeValue(Energy); }
+
+	/** Authority only **/
+	void SetEnergy(float NewValue);
+	void SetEnergyRate(float NewRate);
+
+	FOnTemplateRateAttributeChanged OnEnergyChanged;
+
+	/** Overrides **/
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
+
+protected:
+	UFUNCTION()
+	void OnRep_Energy(const FTemplateRateAttributeData& OldEnergy);
+
+	virtual void OnRateAttributeBoundReached(FTemplateRateAttributeData& Data, bool bReachedMax) override;
+
+	/** Override this function to declare attribute clamp values **/
+	virtual TConstArrayView<FTemplateAttributeMetaData> GetAttributeMetaData() const override;
+
 };
@@ -4,10 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "AttributeSet.h"
+#include "Engine/EngineTypes.h" // for FTimerHandle
 #include "TemplateAttributeSet.generated.h"
 
 // Fwd declaration
 class UTemplateAbilitySystemComponent;
+struct FTemplateAttributeMetaDataTable;
 
 // Define macro for accessing and initializing attributes
 #define ATTRIBUTE_ACCESSORS(ClassName, PropertyName) \
@@ -16,6 +18,77 @@ class UTemplateAbilitySystemComponent;
 		GAMEPLAYATTRIBUTE_VALUE_SETTER(PropertyName) \
 		GAMEPLAYATTRIBUTE_VALUE_INITTER(PropertyName)
 
+// Define macros for declaring attribute clamp metadata inside a static FTemplateAttributeMetaData table
+#define ATTRIBUTE_METADATA(ClassName, PropertyName, MinValue, MaxValue) \
+		FTemplateAttributeMetaData{ &ClassName::Get##PropertyName##Attribute, MinValue, MaxValue, nullptr }
+
+#define ATTRIBUTE_METADATA_CLAMPED_TO(ClassName, PropertyName, MinValue, MaxPropertyName) \
+		FTemplateAttributeMetaData{ &ClassName::Get##PropertyName##Attribute, MinValue, 0.0f, &ClassName::Get##MaxPropertyName##Attribute }
+
+/**
+ * Clamp metadata for a single attribute
+ */
+struct FTemplateAttributeMetaData
+{
+	/** Returns the attribute to clamp **/
+	FGameplayAttribute (*GetAttribute)() = nullptr;
+
+	float MinValue = 0.0f;
+	float MaxValue = 0.0f;
+
+	/** Optional attribute whose current value is used as the upper bound instead of MaxValue **/
+	FGameplayAttribute (*GetMaxAttribute)() = nullptr;
+};
+
+/**
+ * Attribute that moves at a constant rate and is evaluated on demand
+ * (Only rate changes replicate, a constant rate costs nothing per tick. The rate stops at the bound it moves towards)
+ */
+USTRUCT(BlueprintType)
+struct GAMETEMPLATE_API FTemplateRateAttributeData
+{
+	GENERATED_BODY()
+
+	FTemplateRateAttributeData() = default;
+	FTemplateRateAttributeData(float InValue, float InMinValue, float InMaxValue)
+		: BaseValue(InValue), MinValue(InMinValue), MaxValue(InMaxValue)
+	{
+	}
+
+	/** Value at RateStartTime **/
+	UPROPERTY(BlueprintReadOnly, Category="Attributes")
+	float BaseValue = 0.0f;
+
+	/** Change per second, negative values drain **/
+	UPROPERTY(BlueprintReadOnly, Category="Attributes")
+	float Rate = 0.0f;
+
+	/** Server world time BaseValue was taken at **/
+	UPROPERTY(BlueprintReadOnly, Category="Attributes")
+	double RateStartTime = 0.0;
+
+	UPROPERTY(NotReplicated, EditDefaultsOnly, Category="Attributes")
+	float MinValue = 0.0f;
+
+	UPROPERTY(NotReplicated, EditDefaultsOnly, Category="Attributes")
+	float MaxValue = 0.0f;
+
+	/** Returns the value at the given server world time **/
+	float GetValue(double WorldTime) const
+	{
+		return FMath::Clamp(BaseValue + Rate * static_cast<float>(WorldTime - RateStartTime), MinValue, MaxValue);
+	}
+
+	/** Returns the seconds from WorldTime until the value reaches a bound, or a negative value if it never will **/
+	double GetTimeToBound(double WorldTime) const;
+
+	/** Authority only timer firing when the value reaches a bound **/
+	FTimerHandle BoundTimerHandle;
+};
+
+/** Value and rate of a rate attribute after it changed, broadcast on the authority and when it replicates **/
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTemplateRateAttributeChanged, float /*Value*/, float /*Rate*/);
+
 /**
  * Base attribute set class for the project
  * (Do not use it directly)
@@ -29,4 +102,51 @@ public:
 	UTemplateAttributeSet() = default;
 
 	UTemplateAbilitySystemComponent* GetAbilitySystemComponent() const;
+
+	/**
+	 * Writes or restores the base value of every attribute, and the current value and rate of rate attributes
+	 * (Values are stored in property order, only a blob written by the same build can be restored, authority only on load)
+	 */
+	void SerializeCheckpoint(FArchive& Ar);
+
+	/** Overrides **/
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+	virtual void PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const override;
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+
+protected:
+	/** Override to return the static clamp metadata table of this set, indexed once per class by its default object **/
+	virtual TConstArrayView<FTemplateAttributeMetaData> GetAttributeMetaData() const { return {}; }
+
+	/** Clamps the value with the metadata registered for the attribute, if any **/
+	void ClampAttributeValue(const FGameplayAttribute& Attribute, float& NewValue) const;
+
+	/** Returns the value of a rate attribute at the current server time **/
+	float GetRateAttributeValue(const FTemplateRateAttributeData& Data) const;
+
+	/** Rebases the value at the current server time and starts moving at the new rate (authority only) **/
+	void SetRateAttributeRate(FTemplateRateAttributeData& Data, float NewRate);
+
+	/** Sets the value at the current server time and keeps the current rate (authority only) **/
+	void SetRateAttributeValue(FTemplateRateAttributeData& Data, float NewValue);
+
+	/** Called on the authority when a rate attribute reaches its min or max value, its rate is already cleared **/
+	virtual void OnRateAttributeBoundReached(FTemplateRateAttributeData& Data, bool bReachedMax) {}
+
+	/** Coalesce current value changes into one OnAttributesChanged event per frame on the owning ASC **/
+	UPROPERTY(EditDefaultsOnly, Category="Attributes")
+	bool bCoalesceChangeNotifies = false;
+
+private:
+	double GetServerWorldTime() const;
+	void ScheduleRateAttributeBound(FTemplateRateAttributeData& Data);
+
+	/** The timer keeps the property, not a pointer into this set **/
+	void HandleRateAttributeBound(TFieldPath<FStructProperty> Property);
+	void ReachRateAttributeBound(FTemplateRateAttributeData& Data);
+	FStructProperty* FindRateAttributeProperty(const FTemplateRateAttributeData& Data) const;
+
+	/** Clamp metadata of this class, built by the default object and shared by every instance **/
+	TSharedPtr<const FTemplateAttributeMetaDataTable> MetaDataTable;
 };
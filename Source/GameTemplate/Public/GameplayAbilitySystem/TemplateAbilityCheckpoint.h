@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Versioned binary snapshot of a character's ability state
+ * (Granted ability sets with spec levels and InputIDs, active effects with their remaining
+ * duration and attribute values, restored in one pass instead of granting the sets again)
+ */
+struct GAMETEMPLATE_API FTemplateAbilityCheckpoint
+{
+	static constexpr uint32 Magic = 0x43424154; // 'TABC'
+	static constexpr uint32 Version = 2;
+
+	/** Ability granted by a set, in the order of the set's baked table **/
+	struct FAbilityState
+	{
+		int32 Level = 1;
+		int32 InputID = INDEX_NONE;
+	};
+
+	struct FAbilitySetState
+	{
+		FString AbilitySetPath;
+		TArray<FAbilityState> Abilities;
+	};
+
+	struct FEffectState
+	{
+		FString EffectClassPath;
+		float Level = 1.0f;
+		int32 StackCount = 1;
+
+		/** Seconds left, negative for infinite effects **/
+		float RemainingDuration = -1.0f;
+
+		/** Index into AbilitySets of the set that granted the effect, INDEX_NONE otherwise **/
+		int32 AbilitySetIndex = INDEX_NONE;
+	};
+
+	/** Attribute values written by UTemplateAttributeSet::SerializeCheckpoint **/
+	struct FAttributeSetState
+	{
+		FString AttributeSetClassPath;
+		TArray<uint8> Values;
+	};
+
+	TArray<FAbilitySetState> AbilitySets;
+	TArray<FEffectState> Effects;
+	TArray<FAttributeSetState> AttributeSets;
+
+	void Serialize(FArchive& Ar);
+
+	void SaveToBytes(TArray<uint8>& OutBytes);
+	bool LoadFromBytes(const TArray<uint8>& Bytes);
+};
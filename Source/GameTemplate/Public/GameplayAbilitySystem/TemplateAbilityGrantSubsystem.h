@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TemplateAbilityGrantSubsystem.generated.h"
+
+// Fwd declaration
+class AGameTemplateCharacter;
+
+/**
+ * Spreads ability set grants of many characters over several frames
+ * (Set data is resolved when a grant is queued, the per-frame commit only calls into the ASC)
+ */
+UCLASS()
+class GAMETEMPLATE_API UTemplateAbilityGrantSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true when grants should be queued instead of committed right away **/
+	static bool IsTimeSliced();
+
+	/** Prepares the character's ability sets and queues the grant for a later frame **/
+	void QueueGrant(AGameTemplateCharacter* Character);
+
+	/** Drops a queued grant which has not been committed yet **/
+	void CancelGrant(AGameTemplateCharacter* Character);
+
+	/** Overrides **/
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	/** Characters waiting for their ability sets, in queue order **/
+	TArray<TWeakObjectPtr<AGameTemplateCharacter>> PendingGrants;
+};
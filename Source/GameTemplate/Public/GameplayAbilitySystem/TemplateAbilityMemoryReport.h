@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fwd declaration
+class UWorld;
+
+/**
+ * Bytes used by the ability state of one character
+ * (Object sizes are shallow, containers count their allocated slack)
+ */
+struct GAMETEMPLATE_API FTemplateAbilityMemoryUsage
+{
+	FString CharacterName;
+
+	/** The ability system component object itself **/
+	SIZE_T AbilitySystemComponent = 0;
+
+	/** Activatable spec array and instanced abilities **/
+	SIZE_T ActivatableAbilities = 0;
+
+	/** Active gameplay effects **/
+	SIZE_T ActiveEffects = 0;
+
+	/** Granted attribute set objects **/
+	SIZE_T AttributeSets = 0;
+
+	/** MappedAbilities and its bound ability stacks **/
+	SIZE_T InputBindings = 0;
+
+	/** Grant bookkeeping per ability set name **/
+	TArray<TPair<FString, SIZE_T>> AbilitySets;
+
+	SIZE_T GetAbilitySetsTotal() const;
+	SIZE_T GetTotal() const;
+};
+
+namespace TemplateAbilityMemoryReport
+{
+	/** Collects the ability state memory of every character in the world, used by the console command and automation **/
+	GAMETEMPLATE_API void Gather(UWorld* World, TArray<FTemplateAbilityMemoryUsage>& OutUsages);
+
+	/** Prints per-character bytes, totals and the largest contributors **/
+	GAMETEMPLATE_API void Print(TArray<FTemplateAbilityMemoryUsage> Usages, int32 NumLargest, FOutputDevice& Ar);
+}
@@ -5,8 +5,79 @@
 #include "CoreMinimal.h"
 #include "AbilitySystemComponent.h"
 #include "TemplateGameplayAbility.h"
+#include "TemplateGameplayTagBits.h"
 #include "TemplateAbilitySystemComponent.generated.h"
 
+// Fwd declaration
+struct FTemplateAbilityMemoryUsage;
+
+/**
+ * Attribute current value change coalesced over a frame
+ */
+struct FTemplateAttributeChange
+{
+	FGameplayAttribute Attribute;
+
+	/** Value before the first change this frame **/
+	float OldValue = 0.0f;
+
+	/** Value after the last change this frame **/
+	float NewValue = 0.0f;
+};
+
+/**
+ * Update rates used by ability systems of pawns within a significance bucket
+ */
+USTRUCT()
+struct FTemplateSignificanceBucket
+{
+	GENERATED_BODY()
+
+	/** Pawns closer than this to any player use this bucket **/
+	UPROPERTY(EditDefaultsOnly)
+	float MaxDistance = 0.0f;
+
+	/** Tick interval of the ability system component (0 ticks every frame) **/
+	UPROPERTY(EditDefaultsOnly)
+	float TickInterval = 0.0f;
+
+	/** Net update frequency of the owning actor, never above the frequency the actor had without a bucket **/
+	UPROPERTY(EditDefaultsOnly)
+	float NetUpdateFrequency = 100.0f;
+
+	/**
+	 * Hold back gameplay cues on clients while in this bucket, persistent ones catch up when the pawn leaves it
+	 * (Never on the authority, it multicasts cues to every client)
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	bool bSuppressGameplayCues = false;
+};
+
+/**
+ * Ability network traffic counted by the ability system components of one world since the last reset
+ */
+struct FTemplateAbilityNetCounters
+{
+	/** Activation requests received by the server **/
+	int32 ServerActivationRequests = 0;
+
+	/** Predicted activations the server failed and rejected back to the client **/
+	int32 PredictionRejections = 0;
+
+	/** Activations that failed on the server, predicted or not **/
+	int32 ServerActivationFailures = 0;
+
+	/** Batched ability RPCs received by the server, each one replaces up to three RPCs **/
+	int32 BatchedRPCs = 0;
+
+	/** Try activate and end ability RPCs received outside of a batch **/
+	int32 UnbatchedActivationRPCs = 0;
+	int32 UnbatchedEndAbilityRPCs = 0;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTemplateAttributesChanged, UTemplateAbilitySystemComponent*, TConstArrayView<FTemplateAttributeChange>);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTemplateAbilitySpecReplicated, FGameplayAbilitySpec&);
+
 /**
  * Base ability system component class used by this project
  */
@@ -18,7 +89,104 @@ class GAMETEMPLATE_API UTemplateAbilitySystemComponent : public UAbilitySystemCo
 public:
 	/** Overrides **/
 	virtual void InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor) override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void InternalServerTryActivateAbility(FGameplayAbilitySpecHandle AbilityToActivate, bool InputPressed, const FPredictionKey& PredictionKey, const FGameplayEventData* TriggerEventData) override;
+	virtual void NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason) override;
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
+	virtual bool ShouldDoServerAbilityRPCBatch() const override { return true; }
+	virtual void AbilityLocalInputPressed(int32 InputID) override;
+	virtual void ServerAbilityRPCBatch_Internal(FServerAbilityRPCBatch& BatchInfo) override;
+	virtual void ServerEndAbility_Implementation(FGameplayAbilitySpecHandle AbilityToEnd, FGameplayAbilityActivationInfo ActivationInfo, FPredictionKey PredictionKey) override;
+
+	/** Applies the update rates of a significance bucket to this component and its owner **/
+	void ApplySignificanceBucket(const FTemplateSignificanceBucket& Bucket);
+
+	/** Gives the owner back the net update frequency it had before the first bucket was applied, and stops suppressing cues **/
+	void ResetSignificanceBucket();
+
+	/** Adds the bytes used by this component, its specs, active effects and attribute sets to the report **/
+	void AccumulateMemoryUsage(FTemplateAbilityMemoryUsage& Usage) const;
 
 	/** Returns a list of currently active ability instances that match the tags **/
 	void GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer,TArray<UTemplateGameplayAbility*>& ActiveAbilities);
+
+	/**
+	 * Makes an outgoing spec by cloning a prebuilt prototype, giving it this component's effect context and capturing source data
+	 * (Only skips the definition setup of MakeOutgoingSpec, modifier magnitudes are still evaluated when the spec is applied)
+	 */
+	FGameplayEffectSpecHandle MakeOutgoingSpecFromPrototype(const FGameplayEffectSpec& Prototype);
+
+	/** Applies a list of specs to self inside a single aggregator batch, so dirty attributes are re-evaluated once at the end **/
+	void ApplyGameplayEffectSpecsToSelf(TConstArrayView<FGameplayEffectSpecHandle> SpecHandles, TArray<FActiveGameplayEffectHandle>& OutEffectHandles);
+
+	/** Applies one spec to every target, sharing the spec and its context and batching aggregator updates across all of them **/
+	void ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpec& Spec, TConstArrayView<UAbilitySystemComponent*> Targets, TArray<FActiveGameplayEffectHandle>& OutEffectHandles);
+
+	/** Makes a single outgoing spec for the effect and applies it to every target **/
+	void ApplyGameplayEffectToTargets(TSubclassOf<UGameplayEffect> GameplayEffectClass, float Level, TConstArrayView<UAbilitySystemComponent*> Targets, TArray<FActiveGameplayEffectHandle>& OutEffectHandles);
+
+	/**
+	 * Owned tags with parents expanded as a bitset, null when the bitset isn't kept (Template.AbilitySystem.OwnedTagBits)
+	 * or an owned tag has no net index. Built again when the tag tree changed
+	 */
+	const FTemplateGameplayTagBits* GetOwnedTagBits() const;
+
+	/** Number of abilities activated on this component so far, used to tell whether a call activated anything **/
+	uint32 GetNumActivations() const { return NumActivations; }
+
+	/** Number of activations that failed on this component so far, local checks and server side ones **/
+	uint32 GetNumActivationFailures() const { return NumActivationFailures; }
+
+	/** Queues an attribute change to be dispatched with the rest of this frame's changes **/
+	void QueueAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue);
+
+	/** Broadcast at most once per frame with every attribute changed by sets that opted into coalescing **/
+	FOnTemplateAttributesChanged OnAttributesChanged;
+
+	/** Broadcast on clients when a spec replicates in, or is about to be removed by replication **/
+	FOnTemplateAbilitySpecReplicated OnAbilitySpecGiven;
+	FOnTemplateAbilitySpecReplicated OnAbilitySpecRemoved;
+
+protected:
+	/** Overrides **/
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+private:
+	void DispatchAttributeChanges();
+
+	/** Counters of this component's world, kept by the soak report subsystem (null when it doesn't exist) **/
+	FTemplateAbilityNetCounters* GetNetCounters() const;
+
+	/** Attribute changes waiting for the next tick dispatch **/
+	TArray<FTemplateAttributeChange> PendingAttributeChanges;
+	bool bAttributeChangeDispatchQueued = false;
+
+	/** Set while the server handles a client predicted activation request **/
+	bool bHandlingPredictedActivation = false;
+
+	/** Set while the server unpacks a batched ability RPC **/
+	bool bHandlingRPCBatch = false;
+
+	uint32 NumActivations = 0;
+	uint32 NumActivationFailures = 0;
+
+	/** Owner's net update frequency without a bucket, and the one the last bucket set, to notice changes made by others **/
+	TOptional<float> UnthrottledNetUpdateFrequency;
+	float AppliedNetUpdateFrequency = 0.0f;
+
+	/** Starts or stops suppressing cues, persistent cues that changed meanwhile are started or ended when it stops **/
+	void SetGameplayCueSuppression(bool bSuppress);
+	void CatchUpPersistentGameplayCues();
+
+	/** Persistent cues shown when suppression started, effect cues by effect and loose cues by tag **/
+	TMap<FActiveGameplayEffectHandle, FGameplayTagContainer> SuppressedEffectCues;
+	TArray<FGameplayTag> SuppressedLooseCues;
+
+	void HandleOwnedTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void RebuildOwnedTagBits() const;
+
+	/** Kept in sync through the generic tag event, which fires for parent tags too **/
+	mutable FTemplateGameplayTagBits OwnedTagBits;
+	FDelegateHandle OwnedTagBitsHandle;
 };
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TemplateAttributeSnapshotSubsystem.generated.h"
+
+// Fwd declaration
+class UTemplateAbilitySystemComponent;
+struct FOnAttributeChangeData;
+
+/**
+ * Mirrors tracked attributes of every registered ability system into dense per-attribute arrays
+ * (Used for crowd-wide queries which would otherwise visit every ASC and attribute set)
+ */
+UCLASS()
+class GAMETEMPLATE_API UTemplateAttributeSnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Starts mirroring an attribute for every registered ability system **/
+	void TrackAttribute(const FGameplayAttribute& Attribute);
+
+	/** Registers an ability system and returns its stable slot index **/
+	int32 RegisterAbilitySystem(UTemplateAbilitySystemComponent* Asc);
+	void UnregisterAbilitySystem(UTemplateAbilitySystemComponent* Asc);
+
+	/** Returns the values of a tracked attribute indexed by slot, free slots and missing attributes hold NaN **/
+	TConstArrayView<float> GetAttributeValues(const FGameplayAttribute& Attribute) const;
+
+	/** Returns the ability system registered at a slot **/
+	UTemplateAbilitySystemComponent* GetAbilitySystemAtSlot(int32 Slot) const;
+
+	/** Collects the slots whose attribute value is below the threshold **/
+	void GatherSlotsBelow(const FGameplayAttribute& Attribute, float Threshold, TArray<int32>& OutSlots) const;
+
+	/** Collects the ability systems whose attribute value is below the threshold **/
+	void GatherAbilitySystemsBelow(const FGameplayAttribute& Attribute, float Threshold, TArray<UTemplateAbilitySystemComponent*>& OutAbilitySystems) const;
+
+protected:
+	/** Overrides **/
+	virtual void Deinitialize() override;
+
+private:
+	struct FAttributeColumn
+	{
+		FGameplayAttribute Attribute;
+		TArray<float> Values;
+	};
+
+	void BindColumn(int32 ColumnIndex, int32 Slot);
+	void UnbindSlot(int32 Slot);
+	void HandleAttributeChanged(const FOnAttributeChangeData& ChangeData, int32 ColumnIndex, int32 Slot);
+
+private:
+	/** One column per tracked attribute **/
+	TArray<FAttributeColumn> Columns;
+
+	/** Registered ability systems indexed by slot **/
+	TArray<TWeakObjectPtr<UTemplateAbilitySystemComponent>> Slots;
+
+	/** Change delegate handles indexed by slot, then by column **/
+	TArray<TArray<FDelegateHandle>> SlotDelegateHandles;
+
+	TArray<int32> FreeSlots;
+	TMap<TObjectKey<UTemplateAbilitySystemComponent>, int32> SlotByAbilitySystem;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Abilities/GameplayAbility.h"
+#include "TemplateGameplayTagBits.h"
 #include "TemplateGameplayAbility.generated.h"
 
 // Fwd declaration (to avoid circular dependency)
@@ -32,9 +33,17 @@ public:
 
 protected:
 
+	/** Sends the server RPCs of an input activation (activate, target data, end) as one batched RPC **/
+	UPROPERTY(EditDefaultsOnly, Category = "Ability|Network")
+	bool bBatchServerRPCs = false;
+
 	/** Overrides **/
 	virtual void OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	virtual void OnRemoveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
+	virtual bool DoesAbilitySatisfyTagRequirements(const UAbilitySystemComponent& AbilitySystemComponent, const FGameplayTagContainer* SourceTags = nullptr, const FGameplayTagContainer* TargetTags = nullptr, FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 protected:
 	
@@ -45,5 +54,9 @@ protected:
 	/** Can be called when ability is removed from the ability system component **/
 	UFUNCTION(BlueprintImplementableEvent, Category = "Ability")
 	void OnAbilityRemoved();
-	
+
+private:
+	/** Activation tag requirements as bitset queries, built on first use **/
+	mutable TOptional<FTemplateGameplayTagBits> ActivationRequiredTagBits;
+	mutable TOptional<FTemplateGameplayTagBits> ActivationBlockedTagBits;
 };
\ No newline at end of file
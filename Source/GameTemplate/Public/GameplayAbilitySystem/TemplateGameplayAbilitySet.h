@@ -4,12 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "GameplayEffect.h"
 #include "TemplateGameplayAbility.h"
+#include "TemplateAbilityCheckpoint.h"
 #include "TemplateGameplayAbilitySet.generated.h"
 
 // Fwd declaration
 class UTemplateAbilitySystemComponent;
 class UInputAction;
+class UInputMappingContext;
 
 /**
  *	Data used by the ability set to grant gameplay ability
@@ -30,6 +33,10 @@ struct FAbilityBindInfo
 	/** Input action to process input for the ability **/
 	UPROPERTY(EditDefaultsOnly, meta=(Categories="InputAction"))
 	TSoftObjectPtr<UInputAction> InputAction = nullptr;
+
+	/** Milliseconds a press that couldn't activate the ability is held and retried (0 drops it) **/
+	UPROPERTY(EditDefaultsOnly, meta=(ClampMin="0", Units="ms"))
+	float InputBufferTime = 0.0f;
 };
 
 /**
@@ -63,39 +70,101 @@ struct FAttributeBindInfo
 };
 
 /**
- * Data asset used to grant gameplay ability
+ *	Data used by the ability set to add input mapping contexts for its abilities.
  */
-UCLASS(BlueprintType)
-class GAMETEMPLATE_API UTemplateGameplayAbilitySet : public UPrimaryDataAsset
+USTRUCT()
+struct FMappingContextBindInfo
 {
 	GENERATED_BODY()
 
-	/** Abilities to add to the ASC **/
-	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
-	TArray<FAbilityBindInfo> Abilities;
+	/** Mapping context to add to the local player **/
+	UPROPERTY(EditDefaultsOnly)
+	TSoftObjectPtr<UInputMappingContext> MappingContext = nullptr;
 
-	/** Effect to add to the ASC **/
-	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
+	/** Priority of the mapping context **/
+	UPROPERTY(EditDefaultsOnly)
+	int32 Priority = 1;
+};
+
+/**
+ *	Mapping context entry of a baked ability set table.
+ */
+USTRUCT()
+struct FTemplateBakedMappingContextEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UInputMappingContext> MappingContext = nullptr;
+
+	UPROPERTY()
+	int32 Priority = 1;
+};
+
+/**
+ *	Ability entry of a baked ability set table.
+ */
+USTRUCT()
+struct FTemplateBakedAbilityEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<UTemplateGameplayAbility> AbilityClass;
+
+	UPROPERTY()
+	int32 AbilityLevel = 1;
+
+	UPROPERTY()
+	TObjectPtr<UInputAction> InputAction = nullptr;
+
+	UPROPERTY()
+	float InputBufferTime = 0.0f;
+};
+
+/**
+ *	Flattened, validated copy of an ability set's entries, baked when the set is saved or cooked.
+ *	(Holds hard references, so everything a grant needs is loaded with the set)
+ */
+USTRUCT()
+struct FTemplateAbilitySetBakedTable
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TSubclassOf<UAttributeSet>> AttributeSets;
+
+	UPROPERTY()
+	TArray<FTemplateBakedAbilityEntry> Abilities;
+
+	UPROPERTY()
 	TArray<FEffectBindInfo> Effects;
 
-	/** Attributes to add to the ASC **/
-	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
-	TArray<FAttributeBindInfo> Attributes;
-	
-public:
-	void GiveAbilities(UTemplateAbilitySystemComponent* Asc,AGameTemplateCharacter* PlayerCharacter);
-	void RemoveAbilities(UTemplateAbilitySystemComponent* Asc,AGameTemplateCharacter* PlayerCharacter);
+	UPROPERTY()
+	TArray<FTemplateBakedMappingContextEntry> InputMappingContexts;
+
+	/** Hash of the source entries the table was baked from, 0 when never baked **/
+	UPROPERTY()
+	uint32 SourceHash = 0;
+};
+
+/**
+ *	Handles of everything an ability set granted to one character, used to take it away again.
+ */
+USTRUCT()
+struct FTemplateAbilitySetGrantedHandles
+{
+	GENERATED_BODY()
 
-private:
-	void BindAbility(AGameTemplateCharacter* PlayerCharacter, struct FGameplayAbilitySpec& Spec) const;
-	void UnbindAbility(AGameTemplateCharacter* PlayerCharacter, struct FGameplayAbilitySpec& Spec) const;
-	
 	void AddAbilitySpecHandles(const FGameplayAbilitySpecHandle& Handle);
 	void AddEffectSpecHandles(const FActiveGameplayEffectHandle& Handle);
 	void AddAttributeSet(UAttributeSet* Set);
 	void AddAbilitiesSpec(const FGameplayAbilitySpec& Spec);
+	void Reset();
+
+	/** Returns the bytes allocated by the stored handles **/
+	SIZE_T GetAllocatedSize() const;
 
-private:
 	/** Stored handles to the granted abilities **/
 	UPROPERTY()
 	TArray<FGameplayAbilitySpecHandle> AbilitySpecHandles;
@@ -113,4 +182,116 @@ private:
 	TArray<TObjectPtr<UAttributeSet>> GrantedAttributeSets;
 };
 
+/**
+ *	Runtime data built once from the baked table, shared by every grant of the set.
+ *	(Holds class defaults, dropped in the editor when Blueprint classes are reinstanced)
+ */
+struct FTemplateAbilitySetGrantData
+{
+	struct FAbilityEntry
+	{
+		UTemplateGameplayAbility* AbilityCDO = nullptr;
+		int32 AbilityLevel = 1;
+		UInputAction* InputAction = nullptr;
+		float InputBufferTime = 0.0f;
+	};
+
+	struct FEffectEntry
+	{
+		TSubclassOf<UGameplayEffect> EffectClass;
+		float EffectLevel = 1.0f;
+
+		/**
+		 * Prebuilt spec, cloned and captured against the owning ASC on every grant
+		 * (Null for effects with conditional effects, those depend on the source tags and are built per grant)
+		 */
+		TSharedPtr<const FGameplayEffectSpec> Prototype;
+	};
+
+	TArray<FAbilityEntry> Abilities;
+
+	TArray<FEffectEntry> Effects;
+
+	TArray<TSubclassOf<UAttributeSet>> AttributeSets;
+
+	TArray<FTemplateBakedMappingContextEntry> InputMappingContexts;
+};
+
+/**
+ * Data asset used to grant gameplay ability
+ */
+UCLASS(BlueprintType)
+class GAMETEMPLATE_API UTemplateGameplayAbilitySet : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+	/** Abilities to add to the ASC **/
+	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
+	TArray<FAbilityBindInfo> Abilities;
+
+	/** Effect to add to the ASC **/
+	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
+	TArray<FEffectBindInfo> Effects;
+
+	/** Attributes to add to the ASC **/
+	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
+	TArray<FAttributeBindInfo> Attributes;
+
+	/** Mapping contexts to add to the local player while the set is granted **/
+	UPROPERTY(EditDefaultsOnly, Category="AbilitySet")
+	TArray<FMappingContextBindInfo> InputMappingContexts;
+	
+public:
+	void GiveAbilities(UTemplateAbilitySystemComponent* Asc,AGameTemplateCharacter* PlayerCharacter, FTemplateAbilitySetGrantedHandles& OutGrantedHandles);
+	void RemoveAbilities(UTemplateAbilitySystemComponent* Asc,AGameTemplateCharacter* PlayerCharacter, FTemplateAbilitySetGrantedHandles& GrantedHandles) const;
+
+	/**
+	 * Grants the attribute sets and abilities with the levels and InputIDs of a checkpoint, without the set's effects
+	 * (The checkpoint restores effects itself, states that don't match the baked table fall back to the table's levels)
+	 */
+	void RestoreAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter,
+		TConstArrayView<FTemplateAbilityCheckpoint::FAbilityState> AbilityStates, FTemplateAbilitySetGrantedHandles& OutGrantedHandles);
+
+	/** Builds the runtime data from the baked table on first use, every later grant only walks the result **/
+	const FTemplateAbilitySetGrantData& GetGrantData();
+
+	/** Finds the entry a spec granted by this set was made from, used by clients to bind specs replicated to them **/
+	const FTemplateAbilitySetGrantData::FAbilityEntry* FindAbilityEntry(const FGameplayAbilitySpec& Spec);
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+	virtual EDataValidationResult IsDataValid(TArray<FText>& ValidationErrors) override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Grants the attribute sets and abilities, shared by GiveAbilities and RestoreAbilities **/
+	void GrantAttributesAndAbilities(UTemplateAbilitySystemComponent* Asc, AGameTemplateCharacter* PlayerCharacter,
+		TConstArrayView<FTemplateAbilityCheckpoint::FAbilityState> AbilityStates, FTemplateAbilitySetGrantedHandles& OutGrantedHandles);
+
+	void BindAbility(AGameTemplateCharacter* PlayerCharacter, const FTemplateAbilitySetGrantData::FAbilityEntry& AbilityEntry, struct FGameplayAbilitySpec& Spec) const;
+	void UnbindAbility(AGameTemplateCharacter* PlayerCharacter, struct FGameplayAbilitySpec& Spec) const;
+
+#if WITH_EDITOR
+	/** Validates the source entries and bakes the valid ones into BakedTable, returns false when any entry is invalid **/
+	bool BakeTable(TArray<FText>& OutErrors);
+
+	/** Validates the source entries and builds a table from the valid ones, without touching BakedTable **/
+	bool BuildBakedTable(FTemplateAbilitySetBakedTable& OutTable, TArray<FText>& OutErrors) const;
+
+	/** Hash of the source entries, compared against the baked one to detect stale tables **/
+	uint32 ComputeSourceHash() const;
+
+	/** Drops the runtime data of every set when classes it points into are reinstanced **/
+	static void HandleObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+#endif
+
+private:
+	UPROPERTY()
+	FTemplateAbilitySetBakedTable BakedTable;
+
+	/** Runtime data, built by GetGrantData **/
+	TOptional<FTemplateAbilitySetGrantData> GrantData;
+};
+
 
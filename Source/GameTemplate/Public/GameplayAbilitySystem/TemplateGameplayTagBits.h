@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Dense bitset of gameplay tags indexed by tag net index
+ * (Owned sets hold every tag with its parents expanded, queries hold their explicit tags,
+ * so hierarchical matching reduces to word-wide AND operations.
+ * Net indices change when the tag tree is rebuilt, stale bits must be built again)
+ */
+struct GAMETEMPLATE_API FTemplateGameplayTagBits
+{
+	/** Builds a query from the explicit tags of a container **/
+	static FTemplateGameplayTagBits MakeQuery(const FGameplayTagContainer& Tags);
+
+	/** Sets or clears the bit of a single tag, parents are not touched **/
+	void SetTag(const FGameplayTag& Tag, bool bValue);
+
+	/** Sets the bits of a tag and all of its parents **/
+	void AddTagAndParents(const FGameplayTag& Tag);
+
+	/** Clears every bit and stamps the bits with the current tag tree **/
+	void Reset();
+
+	/** True when the tag tree changed since the bits were built, their indices point at other tags **/
+	bool IsStale() const;
+
+	/** False when a set tag had no net index, the bits can't answer for it **/
+	bool IsComplete() const { return bComplete; }
+
+	bool HasTag(const FGameplayTag& Tag) const;
+
+	/** True when every tag of the query is set **/
+	bool HasAll(const FTemplateGameplayTagBits& Query) const;
+
+	/** True when any tag of the query is set **/
+	bool HasAny(const FTemplateGameplayTagBits& Query) const;
+
+	SIZE_T GetAllocatedSize() const { return Words.GetAllocatedSize(); }
+
+private:
+	/** Returns the bit index of a tag, INDEX_NONE for tags without a net index **/
+	static int32 GetBitIndex(const FGameplayTag& Tag);
+
+	/** Bumped every time the tag tree changes **/
+	static uint32 GetTagTreeGeneration();
+
+	FORCEINLINE uint64 GetWord(int32 WordIndex) const { return WordIndex < Words.Num() ? Words[WordIndex] : 0; }
+
+	/** 256 tags fit inline **/
+	TArray<uint64, TInlineAllocator<4>> Words;
+
+	uint32 TagTreeGeneration = GetTagTreeGeneration();
+	bool bComplete = true;
+};
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TemplateAbilitySystemComponent.h"
+#include "TemplateSoakReportSubsystem.generated.h"
+
+/**
+ * Periodically logs game thread time, ability RPC counts and per connection traffic
+ * (Enabled with Template.Soak.ReportInterval, used by the local soak harness)
+ */
+UCLASS()
+class GAMETEMPLATE_API UTemplateSoakReportSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Counted by the ability system components of this world, reset with every report **/
+	FTemplateAbilityNetCounters& GetNetCounters() { return NetCounters; }
+
+	/** Overrides **/
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	void Report();
+
+private:
+	double NextReportTime = 0.0;
+	int32 NumFrames = 0;
+	double GameThreadMsSum = 0.0;
+	double GameThreadMsMax = 0.0;
+
+	FTemplateAbilityNetCounters NetCounters;
+};
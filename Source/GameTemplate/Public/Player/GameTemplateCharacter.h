@@ -10,11 +10,15 @@
 #include "EnhancedInputComponent.h" // for FInputBindingHandle
 #include "GameplayAbilitySystem/TemplateGameplayAbilitySet.h"
 #include "GameplayAbilitySystem/TemplateAbilitySystemComponent.h"
+#include "Player/TemplateInputRecording.h"
 
 #include "GameTemplateCharacter.generated.h"
 
 // Forward declaration
 class UEnhancedInputLocalPlayerSubsystem;
+class UInputMappingContext;
+class UTemplateInputReplaySubsystem;
+struct FTemplateAbilityMemoryUsage;
 
 USTRUCT()
 struct FAbilityInputBinding
@@ -25,6 +29,26 @@ struct FAbilityInputBinding
 	uint32 OnPressedHandle = 0;
 	uint32 OnReleasedHandle = 0;
 	TArray<FGameplayAbilitySpecHandle> BoundAbilitiesStack;
+
+	/** Input component the handles are bound on, null when not bound **/
+	TWeakObjectPtr<UEnhancedInputComponent> BoundInputComponent;
+
+	/** Milliseconds a blocked press is held and retried, the longest window of the bound abilities **/
+	float InputBufferTime = 0.0f;
+
+	/** World time the buffered press expires at, 0 when no press is buffered **/
+	double BufferedPressExpireTime = 0.0;
+
+	/** Set between the pressed and released events, a buffered press activating after release is released right away **/
+	bool bInputHeld = false;
+};
+
+/** Input mapping context add or remove waiting for the next flush **/
+struct FPendingMappingContextChange
+{
+	UInputMappingContext* MappingContext = nullptr;
+	int32 Priority = 0;
+	bool bAdd = true;
 };
 
 /*
@@ -42,11 +66,11 @@ protected:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly)
 	UTemplateAbilitySystemComponent* AbilitySystemComponent;
 
-	/** Camera boom positioning the camera behind the character */
+	/** Camera boom positioning the camera behind the character (null on dedicated servers) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera)
 	class USpringArmComponent* CameraBoom;
 
-	/** Follow camera */
+	/** Follow camera (null on dedicated servers) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera)
 	class UCameraComponent* FollowCamera;
 
@@ -70,6 +94,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input)
 	class UInputAction* LookAction;
 
+	/** Significance buckets ordered by distance, the last bucket is used beyond every MaxDistance */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Significance)
+	TArray<FTemplateSignificanceBucket> SignificanceBuckets;
+
+	/** Seconds between significance updates */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Significance)
+	float SignificanceUpdateInterval = 0.5f;
+
 public:
 	AGameTemplateCharacter();
 
@@ -77,14 +109,39 @@ public:
 	//@NOTE: Remove for example on abilities swapping, it is also called pawn it's detached or destroyed from a controller
 	void RemoveAbilities();
 
+	/** Grants every ability set right away, GiveAbilities may defer this to the grant subsystem **/
+	void CommitAbilitySets();
+
+	const TArray<UTemplateGameplayAbilitySet*>& GetAbilitySets() const { return AbilitySets; }
+
+	/** Writes the granted ability sets, spec levels and InputIDs, active effects and attribute values into the checkpoint **/
+	void SaveAbilityCheckpoint(FTemplateAbilityCheckpoint& OutCheckpoint) const;
+
+	/**
+	 * Brings the granted sets and active effects to the checkpoint in one aggregator batch (authority only)
+	 * (Sets still granted keep their specs and unchanged infinite effects, the others are granted from their baked tables)
+	 */
+	bool RestoreAbilityCheckpoint(const FTemplateAbilityCheckpoint& Checkpoint);
+
+	/** Adds the bytes used by this character's ability system, input bindings and grant bookkeeping to the report **/
+	void AccumulateAbilityMemoryUsage(FTemplateAbilityMemoryUsage& Usage) const;
+
 	/** Overrides **/
+	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PossessedBy(AController* NewController) override;
+	virtual void NotifyControllerChanged() override;
 	virtual void UnPossessed() override;
 	virtual void Destroyed() override;
 
 	/** Ability input binding **/
-	void SetInputBinding(UInputAction* InputAction, FGameplayAbilitySpec& AbilitySpec);
+	void SetInputBinding(UInputAction* InputAction, FGameplayAbilitySpec& AbilitySpec, float InputBufferTime = 0.0f);
 	void ClearInputBinding(FGameplayAbilitySpec& AbilitySpec);
+
+	/** Input recording and replay **/
+	void SetInputRecorder(UTemplateInputReplaySubsystem* Recorder) { InputRecorder = Recorder; }
+	void InjectRecordedInput(ETemplateRecordedInputType Type, UInputAction* InputAction, const FVector2D& Value);
 	
 	/** Implement IAbilitySystemInterface **/
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
@@ -96,19 +153,59 @@ protected:
 	/** Called for looking input */
 	void Look(const FInputActionValue& Value);
 
+	/** Called for jumping input */
+	void OnJumpInputPressed();
+	void OnJumpInputReleased();
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
 private:
-	void ResetBinds();
-	void RunAbilitySystemSetup();
+	/** Binds the pressed and released events on the current input component, unless they are already live there **/
+	void BindAbilityInput(UInputAction* InputAction, FAbilityInputBinding& Binding);
+	void UnbindAbilityInput(FAbilityInputBinding& Binding);
+
 	void OnAbilityInputPressed(UInputAction* InputAction);
+
+	/** Presses every InputID of the binding, returns true when the press was blocked locally **/
+	bool PressAbilityInput(FAbilityInputBinding& Binding);
 	void OnAbilityInputReleased(UInputAction* InputAction);
+	void ReleaseAbilityInput(FAbilityInputBinding& Binding);
 
 	void RemoveEntry(UInputAction* InputAction);
 
+	/** Binds the specs replicated to a remote client to the input action of their set entry, the authority binds when granting **/
+	void HandleAbilitySpecGiven(FGameplayAbilitySpec& AbilitySpec);
+	void HandleAbilitySpecRemoved(FGameplayAbilitySpec& AbilitySpec);
+
+	/**
+	 * Ability set mapping contexts, queued and applied with a single control mappings rebuild
+	 * (Adds need a local player controlling this pawn, removals go to the player the contexts were added to)
+	 */
+	UEnhancedInputLocalPlayerSubsystem* GetMappingContextSubsystem(bool bAdd);
+	void SetMappingContextSubsystem(UEnhancedInputLocalPlayerSubsystem* Subsystem);
+	void QueueMappingContextChanges(UTemplateGameplayAbilitySet* AbilitySet, bool bAdd);
+	void FlushMappingContextChanges();
+
+	/** Removes the contexts a remote client added for its ability sets in SetupPlayerInputComponent **/
+	void RemoveClientMappingContexts();
+
+	UFUNCTION()
+	void HandleControlMappingsRebuilt();
+
+	/** Buffered ability input, retried when a tag is removed or an ability ends instead of every tick **/
+	void RetryBufferedAbilityInputs();
+	void UpdateBufferedInputListeners();
+	void HandleBufferedInputTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void HandleBufferedInputAbilityEnded(UGameplayAbility* Ability);
+
 	FGameplayAbilitySpec* FindAbilitySpec(FGameplayAbilitySpecHandle Handle);	
+
+	/** Picks the significance bucket from the distance to the closest player **/
+	void UpdateSignificance();
+
+	void RecordInput(ETemplateRecordedInputType Type, const UInputAction* InputAction = nullptr, const FVector2D& Value = FVector2D::ZeroVector);
 private:
 	UPROPERTY(transient)
 	UEnhancedInputComponent* EnhancedInputComponent;
@@ -116,10 +213,40 @@ private:
 	UPROPERTY(transient)
 	TMap<UInputAction*, FAbilityInputBinding> MappedAbilities;
 
+	/** Handles of everything granted by each ability set **/
+	UPROPERTY(transient)
+	TMap<UTemplateGameplayAbilitySet*, FTemplateAbilitySetGrantedHandles> GrantedAbilitySets;
+
+	int32 SignificanceBucketIndex = INDEX_NONE;
+	FTimerHandle SignificanceTimerHandle;
+
+	/** Mapping context changes applied on the next tick, at most one per context **/
+	TArray<FPendingMappingContextChange> PendingMappingContextChanges;
+	FTimerHandle MappingContextFlushTimerHandle;
+
+	/** Number of queued ability sets holding each mapping context **/
+	UPROPERTY(transient)
+	TMap<UInputMappingContext*, int32> MappingContextRefCounts;
+
+	/** Set while a remote client holds the mapping contexts of its ability sets **/
+	bool bAddedClientMappingContexts = false;
+
+	/** Local player subsystem the ability set mapping contexts were added to, kept to remove them after unpossess (rebuilds are counted while set) **/
+	TWeakObjectPtr<UEnhancedInputLocalPlayerSubsystem> MappingContextSubsystem;
+
+	/** Buffered ability input listeners, only bound while a press is buffered **/
+	FDelegateHandle BufferedInputTagChangedHandle;
+	FDelegateHandle BufferedInputAbilityEndedHandle;
+	FTimerHandle BufferedInputExpireTimerHandle;
+	bool bRetryingBufferedInput = false;
+
+	/** Set while the input handled by this character is being recorded **/
+	TWeakObjectPtr<UTemplateInputReplaySubsystem> InputRecorder;
+
 public:
-	/** Returns CameraBoom subobject **/
+	/** Returns CameraBoom subobject, null on dedicated servers **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
-	/** Returns FollowCamera subobject **/
+	/** Returns FollowCamera subobject, null on dedicated servers **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 };
 
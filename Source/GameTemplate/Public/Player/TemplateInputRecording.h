@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fwd declaration
+class UInputAction;
+
+/** Input handlers of AGameTemplateCharacter which can be recorded and replayed **/
+enum class ETemplateRecordedInputType : uint8
+{
+	Move,
+	Look,
+	JumpPressed,
+	JumpReleased,
+	AbilityPressed,
+	AbilityReleased,
+
+	// Number of types, not a valid event
+	Count
+};
+
+/**
+ * Single recorded input event
+ */
+struct FTemplateRecordedInputEvent
+{
+	/** Frames since the recording started **/
+	uint32 Frame = 0;
+
+	ETemplateRecordedInputType Type = ETemplateRecordedInputType::Move;
+
+	/** Index into the stream's input action table (ability events only) **/
+	uint16 InputActionIndex = 0;
+
+	/** Axis value (move and look events only) **/
+	FVector2f Value = FVector2f::ZeroVector;
+};
+
+/**
+ * Versioned binary stream of recorded input events
+ * (Frames are delta encoded and only move and look events carry a value)
+ */
+struct GAMETEMPLATE_API FTemplateInputStream
+{
+	static constexpr uint32 Magic = 0x504E4954; // 'TINP'
+	static constexpr uint32 Version = 1;
+
+	/** Paths of the ability input actions referenced by the events **/
+	TArray<FString> InputActionPaths;
+
+	TArray<FTemplateRecordedInputEvent> Events;
+
+	/** Returns the table index of an input action, adding it if needed **/
+	uint16 FindOrAddInputAction(const UInputAction* InputAction);
+
+	void Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& FilePath);
+	bool LoadFromFile(const FString& FilePath);
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Player/TemplateInputRecording.h"
+#include "TemplateInputReplaySubsystem.generated.h"
+
+// Fwd declaration
+class AGameTemplateCharacter;
+class UInputAction;
+
+/**
+ * Records the input reaching one character and replays recorded streams into other characters
+ * (Used to drive headless characters with a repeatable input load)
+ */
+UCLASS()
+class GAMETEMPLATE_API UTemplateInputReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Starts recording the input handled by the character **/
+	void StartRecording(AGameTemplateCharacter* Character);
+
+	/** Stops recording and writes the stream to the file **/
+	bool StopRecording(const FString& FilePath);
+
+	/** Called by the recorded character for every input event it handles **/
+	void RecordInput(ETemplateRecordedInputType Type, const UInputAction* InputAction, const FVector2D& Value);
+
+	/**
+	 * Replays the stream into NumCharacters characters, spawning AI controlled ones when there are not enough
+	 * (Playback waits until at least one character is found, e.g. a client's pawn after it connects)
+	 */
+	bool StartReplay(const FString& FilePath, int32 NumCharacters, bool bLoop);
+	void StopReplay();
+
+	/** Overrides **/
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	void GatherReplayCharacters(int32 NumCharacters);
+
+private:
+	TWeakObjectPtr<AGameTemplateCharacter> RecordingCharacter;
+	uint64 RecordingStartFrame = 0;
+	FTemplateInputStream Recording;
+
+	FTemplateInputStream Replay;
+	TArray<TWeakObjectPtr<AGameTemplateCharacter>> ReplayCharacters;
+	int32 ReplayNumCharacters = 0;
+	int32 ReplayNextEvent = 0;
+	uint32 ReplayFrame = 0;
+	bool bReplaying = false;
+	bool bReplayLoop = false;
+
+	/** Input actions of the replayed stream, indexed like its input action table **/
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInputAction>> ReplayInputActions;
+};